@@ -0,0 +1,8 @@
+// x : exposition, y : contraste, z : saturation
+vec4 effect(vec4 color, ivec2 pixel, ivec2 size, vec4 params) {
+    vec3 rgb = color.rgb * params.x;
+    rgb = (rgb - 0.5) * params.y + 0.5;
+    float luminance = dot(rgb, vec3(0.2126, 0.7152, 0.0722));
+    rgb = mix(vec3(luminance), rgb, params.z);
+    return vec4(clamp(rgb, 0.0, 1.0), color.a);
+}
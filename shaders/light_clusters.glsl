@@ -0,0 +1,19 @@
+// Grille de clusters du clustered forward lighting, incluse par light_culling.comp, simple_shader.frag et water.frag
+// après la déclaration de GlobalUbo. Doit correspondre à LightCullingSystem::CLUSTER_* et MAX_LIGHTS_PER_CLUSTER.
+
+const uint CLUSTER_X = 16;
+const uint CLUSTER_Y = 9;
+const uint CLUSTER_Z = 24;
+// au-delà, les lumières suivantes d'un cluster sont ignorées par light_culling.comp et ne l'éclairent pas
+const uint MAX_LIGHTS_PER_CLUSTER = 128;
+
+uint clusterIndex(vec3 positionWorld) {
+    vec4 clip = ubo.projection * ubo.view * vec4(positionWorld, 1.0);
+    // projection[2][3] == 1 : clip.w est la profondeur en espace vue
+    float near = -ubo.projection[3][2] / ubo.projection[2][2];
+    float far = ubo.projection[3][2] / (1.0 - ubo.projection[2][2]);
+    uvec2 tile = uvec2(clamp((clip.xy / clip.w * 0.5 + 0.5) * vec2(CLUSTER_X, CLUSTER_Y), vec2(0.0),
+                             vec2(CLUSTER_X - 1, CLUSTER_Y - 1)));
+    uint slice = uint(clamp(log(clip.w / near) / log(far / near) * float(CLUSTER_Z), 0.0, float(CLUSTER_Z - 1)));
+    return tile.x + tile.y * CLUSTER_X + slice * CLUSTER_X * CLUSTER_Y;
+}
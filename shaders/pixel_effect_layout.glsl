@@ -0,0 +1,18 @@
+// Entrées communes des effets par pixel, incluses par leur shader seul (pixel_effect_main.glsl) et par les shaders
+// fusionnés générés par LvePostFusion. Un effet définit seulement :
+//   vec4 effect(vec4 color, ivec2 pixel, ivec2 size, vec4 params)
+// sans autre fonction ni variable globale, le nom effect étant remplacé à chaque inclusion.
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+layout(set = 0, binding = 0, rgba8) uniform readonly image2D inputImage;
+layout(set = 0, binding = 1, rgba8) uniform writeonly image2D outputImage;
+
+// profondeur linéaire r : min, g : max, voir LveLinearDepth
+layout(set = 1, binding = 0) uniform sampler2D linearDepth;
+
+// params de chaque effet, dans l'ordre de la fusion
+layout(push_constant) uniform Push {
+    vec4 params[8];
+}
+push;
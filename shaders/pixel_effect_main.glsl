@@ -0,0 +1,11 @@
+// main d'un effet par pixel dispatché seul, effect doit être défini avant l'inclusion
+
+void main() {
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(outputImage);
+    if (any(greaterThanEqual(pixel, size))) {
+        return;
+    }
+
+    imageStore(outputImage, pixel, effect(imageLoad(inputImage, pixel), pixel, size, push.params[0]));
+}
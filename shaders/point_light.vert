@@ -4,9 +4,11 @@ const vec2 OFFSETS[6] =
     vec2[](vec2(-1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
 
 layout(location = 0) out vec2 fragOffset;
+layout(location = 1) out vec4 fragColor;
 
-struct PointLight {
-    vec4 position;  // ignore w
+// doit correspondre à LightSprite dans point_light_system.cpp, trié du plus loin au plus proche
+struct LightSprite {
+    vec4 position;  // w is radius
     vec4 color;     // w is intensity
 };
 
@@ -15,25 +17,21 @@ layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 view;
     mat4 invView;
     vec4 ambientLightColor;  // w is intensity
-    PointLight pointLights[10];
     int numLights;
 }
 ubo;
 
-layout(push_constant) uniform Push {
-    vec4 position;
-    vec4 color;
-    float radius;
-}
-push;
+layout(set = 1, binding = 0) readonly buffer SpriteBuffer { LightSprite sprites[]; };
 
 void main() {
+    LightSprite sprite = sprites[gl_InstanceIndex];
     fragOffset = OFFSETS[gl_VertexIndex];
+    fragColor = sprite.color;
     vec3 cameraRightWorld = {ubo.view[0][0], ubo.view[1][0], ubo.view[2][0]};
     vec3 cameraUpWorld = {ubo.view[0][1], ubo.view[1][1], ubo.view[2][1]};
 
-    vec3 positionWorld =
-        push.position.xyz + push.radius * fragOffset.x * cameraRightWorld + push.radius * fragOffset.y * cameraUpWorld;
+    vec3 positionWorld = sprite.position.xyz + sprite.position.w * fragOffset.x * cameraRightWorld +
+                         sprite.position.w * fragOffset.y * cameraUpWorld;
 
     gl_Position = ubo.projection * ubo.view * vec4(positionWorld, 1.0);
 }
\ No newline at end of file
@@ -1,14 +1,17 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec3 fragPosWorld;
 layout(location = 2) in vec3 fragNormalWorld;
 layout(location = 3) in vec2 fragUV;
+layout(location = 4) flat in uint fragTextureIndex;
 
 layout(location = 0) out vec4 outColor;
 
 struct PointLight {
-    vec4 position;  // ignore w
+    vec4 position;  // w is range
     vec4 color;     // w is intensity
 };
 
@@ -18,17 +21,12 @@ layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 invView;
     vec4 sunDirection;
     vec4 ambientLightColor;  // w is intensity
-    PointLight pointLights[10];
     int numLights;
 }
 ubo;
-layout(set = 1, binding = 0) uniform sampler2D image;
-
-layout(push_constant) uniform Push {
-    mat4 modelMatrix;
-    mat4 normalMatrix;
-}
-push;
+// table bindless de LveTextureTable, doit correspondre à LveTextureTable::NO_TEXTURE
+const uint NO_TEXTURE = 0xFFFFFFFF;
+layout(set = 1, binding = 0) uniform sampler2D textures[];
 
 layout(set = 2, binding = 0) uniform sampler2D displacement;
 layout(set = 2, binding = 1) uniform sampler2D derivatives;
@@ -42,6 +40,12 @@ layout(set = 2, binding = 6) uniform sampler2D displacement3;
 layout(set = 2, binding = 7) uniform sampler2D derivatives3;
 layout(set = 2, binding = 8) uniform sampler2D turbulence3;
 
+#include "light_clusters.glsl"
+
+layout(set = 4, binding = 0) readonly buffer LightBuffer { PointLight lights[]; };
+layout(set = 4, binding = 1) readonly buffer ClusterCountBuffer { uint clusterLightCounts[]; };
+layout(set = 4, binding = 2) readonly buffer ClusterIndexBuffer { uint clusterLightIndices[]; };
+
 void main() {
     vec3 diffuseLight = ubo.ambientLightColor.xyz * ubo.ambientLightColor.w;
     vec3 specularLight = vec3(0.0);
@@ -61,8 +65,9 @@ void main() {
     blinnTermSun = pow(blinnTermSun, 65536.0);
     specularLight += blinnTermSun;
 
-    for (int i = 0; i < ubo.numLights; i++) {
-        PointLight light = ubo.pointLights[i];
+    uint cluster = clusterIndex(fragPosWorld);
+    for (uint i = 0; i < clusterLightCounts[cluster]; i++) {
+        PointLight light = lights[clusterLightIndices[cluster * MAX_LIGHTS_PER_CLUSTER + i]];
         vec3 directionToLight = light.position.xyz - fragPosWorld;
         float attenuation = 1.0 / dot(directionToLight, directionToLight);  // distance squared
         directionToLight = normalize(directionToLight);
@@ -80,7 +85,9 @@ void main() {
         specularLight += intensity * blinnTerm;
     }
 
-    vec3 imageColor = texture(image, fragUV).rgb;
+    // l'index varie entre les instances d'un même draw indirect
+    vec3 imageColor = fragTextureIndex == NO_TEXTURE ? fragColor
+                                                     : texture(textures[nonuniformEXT(fragTextureIndex)], fragUV).rgb;
 
     outColor = vec4((diffuseLight * imageColor + specularLight * imageColor), 1.0);
 }
@@ -1,19 +1,20 @@
 #version 450
 const float LOD_SCALE = 7.13;
-layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 color;
-layout(location = 2) in vec3 normal;
+// LveVertexFormat : 0 standard, 1 compressé, 2 compressé avec flux de couleur
+layout(constant_id = 0) const uint VERTEX_FORMAT = 0;
+const uint VERTEX_FORMAT_STANDARD = 0;
+const uint VERTEX_FORMAT_COMPRESSED_COLOR = 2;
+
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec3 inNormal;
 layout(location = 3) in vec2 uv;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec3 fragPosWorld;
 layout(location = 2) out vec3 fragNormalWorld;
 layout(location = 3) out vec2 fragUV;
-
-struct PointLight {
-    vec4 position;  // ignore w
-    vec4 color;     // w is intensity
-};
+layout(location = 4) flat out uint fragTextureIndex;
 
 layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 projection;
@@ -21,7 +22,6 @@ layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 invView;
     vec4 sunDirection;
     vec4 ambientLightColor;  // w is intensity
-    PointLight pointLights[10];
     int numLights;
 }
 ubo;
@@ -38,16 +38,41 @@ layout(set = 2, binding = 6) uniform sampler2D displacement3;
 layout(set = 2, binding = 7) uniform sampler2D derivatives3;
 layout(set = 2, binding = 8) uniform sampler2D turbulence3;
 
-layout(push_constant) uniform Push {
+struct ObjectData {
     mat4 modelMatrix;
     mat4 normalMatrix;
+    vec4 boundingSphere;
+    uvec4 drawInfo;
+};
+
+// rempli par CullingSystem, firstInstance de chaque commande indirecte = index de l'objet
+layout(set = 3, binding = 0) readonly buffer ObjectBuffer { ObjectData objects[]; };
+
+vec3 decodeOctahedral(vec2 encoded) {
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    if (normal.z < 0.0) {
+        normal.xy = (1.0 - abs(normal.yx)) * vec2(normal.x >= 0.0 ? 1.0 : -1.0, normal.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(normal);
 }
-push;
 
 void main() {
-    vec4 positionWorld = push.modelMatrix * vec4(position, 1.0);
+    vec3 position = inPosition.xyz;
+    vec3 normal = inNormal;
+    vec3 color = inColor;
+    if (VERTEX_FORMAT != VERTEX_FORMAT_STANDARD) {
+        // position quantifiée dans la sphère englobante du modèle, voir LveModel::CompressedVertex
+        vec4 boundingSphere = objects[gl_InstanceIndex].boundingSphere;
+        position = boundingSphere.xyz + inPosition.xyz * boundingSphere.w;
+        normal = decodeOctahedral(inNormal.xy);
+        color = VERTEX_FORMAT == VERTEX_FORMAT_COMPRESSED_COLOR ? inColor : vec3(1.0);
+    }
+
+    mat4 modelMatrix = objects[gl_InstanceIndex].modelMatrix;
+    mat4 normalMatrix = objects[gl_InstanceIndex].normalMatrix;
+    vec4 positionWorld = modelMatrix * vec4(position, 1.0);
 
-    vec3 objectPos = vec3(push.modelMatrix[3][0], push.modelMatrix[3][1], push.modelMatrix[3][2]);
+    vec3 objectPos = vec3(modelMatrix[3][0], modelMatrix[3][1], modelMatrix[3][2]);
 
     // Calculate world-space UV coordinates
     vec2 worldUV = vec2(objectPos.xy);
@@ -114,8 +139,9 @@ void main() {
     vec4 Finalposition = positionWorld + vec4(0, displacement, 0, 0);
 
     gl_Position = ubo.projection * ubo.view * Finalposition;
-    fragNormalWorld = normalize(mat3(push.normalMatrix) * normal);
+    fragNormalWorld = normalize(mat3(normalMatrix) * normal);
     fragPosWorld = positionWorld.xyz;
     fragColor = color;
     fragUV = uv;
+    fragTextureIndex = objects[gl_InstanceIndex].drawInfo.w;
 }
@@ -5,18 +5,12 @@ layout(location = 1) in vec2 uv;
 
 layout(location = 0) out vec4 outColor;
 
-struct PointLight {
-    vec4 position;  // ignore w
-    vec4 color;     // w is intensity
-};
-
 layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 projection;
     mat4 view;
     mat4 invView;
     vec4 sunDirection;
     vec4 ambientLightColor;  // w is intensity
-    PointLight pointLights[10];
     int numLights;
 }
 ubo;
@@ -0,0 +1,7 @@
+// x : intensité, y : rayon où l'assombrissement commence, z : largeur du fondu
+vec4 effect(vec4 color, ivec2 pixel, ivec2 size, vec4 params) {
+    vec2 uv = (vec2(pixel) + 0.5) / vec2(size) - 0.5;
+    uv.x *= float(size.x) / float(size.y);
+    float vignette = smoothstep(params.y, params.y + params.z, length(uv));
+    return vec4(color.rgb * (1.0 - params.x * vignette), color.a);
+}
@@ -1,4 +1,5 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 const vec3 LIGHT_WATER_COLOR = vec3(0.f, 0.324f, .7f);
 const vec3 DARK_WATER_COLOR = vec3(0.f, 0.137f, 0.49f);
@@ -12,7 +13,7 @@ layout(location = 4) in vec4 lodScales;
 layout(location = 0) out vec4 outColor;
 
 struct PointLight {
-    vec4 position;  // ignore w
+    vec4 position;  // w is range
     vec4 color;     // w is intensity
 };
 
@@ -22,7 +23,6 @@ layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 invView;
     vec4 sunDirection;
     vec4 ambientLightColor;  // w is intensity
-    PointLight pointLights[10];
     int numLights;
 }
 ubo;
@@ -39,6 +39,12 @@ layout(set = 1, binding = 6) uniform sampler2D displacement3;
 layout(set = 1, binding = 7) uniform sampler2D derivatives3;
 layout(set = 1, binding = 8) uniform sampler2D turbulence3;
 
+#include "light_clusters.glsl"
+
+layout(set = 2, binding = 0) readonly buffer LightBuffer { PointLight lights[]; };
+layout(set = 2, binding = 1) readonly buffer ClusterCountBuffer { uint clusterLightCounts[]; };
+layout(set = 2, binding = 2) readonly buffer ClusterIndexBuffer { uint clusterLightIndices[]; };
+
 layout(push_constant) uniform Push {
     mat4 modelMatrix;
     mat4 normalMatrix;
@@ -81,8 +87,9 @@ void main() {
     blinnTermSun = pow(blinnTermSun, 4096.0);
     specularLight += blinnTermSun;
 
-    for (int i = 0; i < ubo.numLights; i++) {
-        PointLight light = ubo.pointLights[i];
+    uint cluster = clusterIndex(fragPosWorld);
+    for (uint i = 0; i < clusterLightCounts[cluster]; i++) {
+        PointLight light = lights[clusterLightIndices[cluster * MAX_LIGHTS_PER_CLUSTER + i]];
         vec3 directionToLight = light.position.xyz - fragPosWorld;
         float attenuation = 1.0 / dot(directionToLight, directionToLight);  // distance squared
         directionToLight = normalize(directionToLight);
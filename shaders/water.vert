@@ -1,10 +1,16 @@
 #version 450
 const float LOD_SCALE = 7.13;
 
-layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 color;
-layout(location = 2) in vec3 normal;
-layout(location = 3) in vec2 uv;
+// Clipmap ///////////////////////////////
+// doit correspondre à WaterSystem::CLIPMAP_GRID_SIZE / CLIPMAP_LEVELS / CLIPMAP_BASE_SPACING
+// chaque niveau (gl_InstanceIndex) est une grille de GRID_SIZE x GRID_SIZE quads centrée sur la caméra, avec un
+// espacement doublé à chaque niveau et un trou là où le niveau plus fin est déjà dessiné. gl_VertexIndex indexe la
+// grille de (GRID_SIZE + 1)² vertex du niveau, les blocs de l'anneau autour du trou sont placés par le vertexOffset
+const int CLIPMAP_GRID_SIZE = 128;
+const int CLIPMAP_LEVELS = 5;
+const float CLIPMAP_BASE_SPACING = 0.2;
+// fraction extérieure de chaque niveau où les vertex glissent vers la grille du niveau suivant
+const float CLIPMAP_MORPH_REGION = 0.25;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec3 fragPosWorld;
@@ -12,18 +18,12 @@ layout(location = 2) out vec3 fragNormalWorld;
 layout(location = 3) out vec2 fragUV;
 layout(location = 4) out vec4 lodScales;
 
-struct PointLight {
-    vec4 position;  // ignore w
-    vec4 color;     // w is intensity
-};
-
 layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 projection;
     mat4 view;
     mat4 invView;
     vec4 sunDirection;
     vec4 ambientLightColor;  // w is intensity
-    PointLight pointLights[10];
     int numLights;
 }
 ubo;
@@ -40,6 +40,12 @@ layout(set = 1, binding = 6) uniform sampler2D displacement3;
 layout(set = 1, binding = 7) uniform sampler2D derivatives3;
 layout(set = 1, binding = 8) uniform sampler2D turbulence3;
 
+// xy : coin de chaque niveau en multiples de CLIPMAP_BASE_SPACING, calculé par WaterSystem::updateClipmap
+layout(set = 1, binding = 9) uniform ClipmapUbo {
+    ivec4 levelOrigins[CLIPMAP_LEVELS];
+}
+clipmap;
+
 layout(push_constant) uniform Push {
     mat4 modelMatrix;
     mat4 normalMatrix;
@@ -51,7 +57,24 @@ void main() {
     float lengthScale2 = 17;
     float lengthScale3 = 5;
 
-    vec4 positionWorld = push.modelMatrix * vec4(position, 1.0);
+    int level = gl_InstanceIndex;
+    ivec2 vertex = ivec2(gl_VertexIndex % (CLIPMAP_GRID_SIZE + 1), gl_VertexIndex / (CLIPMAP_GRID_SIZE + 1));
+    int step = 1 << level;
+
+    // geomorphing : près du bord, les vertex impairs rejoignent la grille du niveau suivant pour éviter les
+    // T-junctions et les sauts de LOD
+    vec2 fromCenter = abs(vec2(vertex) - 0.5 * CLIPMAP_GRID_SIZE);
+    float borderDist = max(fromCenter.x, fromCenter.y) / (0.5 * CLIPMAP_GRID_SIZE);
+    float morph = clamp((borderDist - (1.0 - CLIPMAP_MORPH_REGION)) / CLIPMAP_MORPH_REGION, 0.0, 1.0);
+    if (level == CLIPMAP_LEVELS - 1) morph = 0.0;
+    // le bord du niveau tombe sur un index pair, les index impairs sont absents du niveau suivant. Position en
+    // multiples de l'espacement de base : un vertex et sa cible au niveau suivant tombent exactement au même endroit
+    vec2 gridCell = vec2(clipmap.levelOrigins[level].xy + vertex * step) - vec2(vertex & 1) * float(step) * morph;
+    // l'océan est rendu à l'échelle 1/2 (Finalposition.w vaut 2)
+    vec2 gridPos = gridCell * CLIPMAP_BASE_SPACING;
+
+    // l'océan n'est que translaté verticalement, sa position horizontale suit la caméra
+    vec4 positionWorld = vec4(gridPos.x, push.modelMatrix[3].y, gridPos.y, 1.0);
 
     // Calculate world-space UV coordinates
     vec2 worldUV = vec2(positionWorld.x, positionWorld.z);
@@ -67,6 +90,11 @@ void main() {
     float lod_c2 = min(LOD_SCALE * lengthScale2 / viewDist, 1);
     float lod_c3 = min(LOD_SCALE * lengthScale3 / viewDist, 1);
 
+    // les vagues s'aplatissent avant le plan far pour rejoindre le plan de water_far.frag
+    float farPlane = ubo.projection[3][2] / (1.0 - ubo.projection[2][2]);
+    float renderedDist = length(ubo.invView[3].xyz - positionWorld.xyz * 0.5);
+    float farFade = 1.0 - smoothstep(0.6 * farPlane, farPlane, renderedDist);
+
     // Initialize displacement and largeWavesBias
     vec3 displacement = vec3(0.0);
     float largeWavesBias = 0.0;
@@ -80,14 +108,16 @@ void main() {
     displacement.xyz += vec3(texture(displacement3, worldUV / lengthScale3).xy * lod_c3,
                              texture(displacement3, worldUV / lengthScale3).z * lod_c3 * 2);
 
+    displacement *= farFade;
+
     // Update vertex position
     vec4 Finalposition = positionWorld + vec4(mat3(push.modelMatrix) * displacement.xzy, 1);
 
     // Output values
     gl_Position = ubo.projection * ubo.view * Finalposition;
-    fragNormalWorld = normalize(mat3(push.normalMatrix) * normal);
+    fragNormalWorld = normalize(mat3(push.normalMatrix) * vec3(0.0, -1.0, 0.0));
     fragPosWorld = Finalposition.xyz / 2.f;
-    fragColor = color;
+    fragColor = vec3(1.0);
     fragUV = worldUV;
     lodScales = vec4(lod_c1, lod_c2, lod_c3, max(displacement.y - largeWavesBias * 0.8 + 0.1, 0) / 4.8);
 }
\ No newline at end of file
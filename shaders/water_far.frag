@@ -0,0 +1,101 @@
+#version 450
+
+const vec3 LIGHT_WATER_COLOR = vec3(0.f, 0.324f, .7f);
+const vec3 DARK_WATER_COLOR = vec3(0.f, 0.137f, 0.49f);
+const float LOD_SCALE = 7.13;
+// doit correspondre à la taille des textures de WaveGen
+const float CASCADE_RESOLUTION = 512.0;
+
+layout(location = 0) in vec3 fragViewDirection;
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform GlobalUbo {
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 sunDirection;
+    vec4 ambientLightColor;  // w is intensity
+    int numLights;
+}
+ubo;
+
+layout(set = 1, binding = 1) uniform sampler2D derivatives;
+layout(set = 1, binding = 2) uniform sampler2D turbulence;
+
+layout(set = 1, binding = 4) uniform sampler2D derivatives2;
+layout(set = 1, binding = 5) uniform sampler2D turbulence2;
+
+layout(set = 1, binding = 7) uniform sampler2D derivatives3;
+layout(set = 1, binding = 8) uniform sampler2D turbulence3;
+
+layout(push_constant) uniform Push {
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+}
+push;
+
+// les cascades n'ont pas de mipmaps : on atténue chaque cascade selon le nombre de texels couverts par le pixel,
+// ce qui revient à lire un mip très filtré où la pente moyenne tend vers 0
+float cascadeWeight(vec2 footprint, float lengthScale) {
+    float texels = max(footprint.x, footprint.y) / lengthScale * CASCADE_RESOLUTION;
+    return clamp(2.0 - texels, 0.0, 1.0);
+}
+
+void main() {
+    float lengthScale1 = 250;
+    float lengthScale2 = 17;
+    float lengthScale3 = 5;
+
+    // intersection du rayon de vue avec le plan de l'océan, rendu à l'échelle 1/2 comme dans water.vert
+    vec3 cameraPosWorld = ubo.invView[3].xyz;
+    float oceanHeight = push.modelMatrix[3][1] * 0.5;
+    float t = (oceanHeight - cameraPosWorld.y) / fragViewDirection.y;
+    if (t <= 0.0) {
+        discard;
+    }
+    vec3 hitPosWorld = cameraPosWorld + t * fragViewDirection;
+    vec2 worldUV = hitPosWorld.xz * 2.0;
+    vec2 footprint = fwidth(worldUV);
+
+    // mêmes facteurs de LOD que water.vert pour que la jonction avec le maillage proche soit invisible
+    float viewDist = length(cameraPosWorld - vec3(worldUV.x, push.modelMatrix[3][1], worldUV.y));
+    vec3 lodScales = min(LOD_SCALE * vec3(lengthScale1, lengthScale2, lengthScale3) / viewDist, vec3(1.0));
+    vec3 weights = vec3(cascadeWeight(footprint, lengthScale1), cascadeWeight(footprint, lengthScale2),
+                        cascadeWeight(footprint, lengthScale3)) *
+                   vec3(1.0, lodScales.y, lodScales.z);
+
+    vec4 sumderivatives = texture(derivatives, worldUV / lengthScale1) * weights.x;
+    sumderivatives += texture(derivatives2, worldUV / lengthScale2) * weights.y;
+    sumderivatives += texture(derivatives3, worldUV / lengthScale3) * weights.z;
+
+    vec2 slope = vec2(sumderivatives.x / (1 + sumderivatives.z), sumderivatives.y / (1 + sumderivatives.w));
+    vec3 worldNormal = normalize(vec3(-slope.x, 1, -slope.y));
+    vec3 surfaceNormal = normalize(mat3(push.normalMatrix) * vec3(worldNormal.x, -worldNormal.y, worldNormal.z));
+
+    // même éclairage que water.frag, sans les point lights dont l'atténuation est nulle à cette distance
+    vec3 viewDirection = normalize(cameraPosWorld - hitPosWorld);
+    vec3 diffuseLight = ubo.ambientLightColor.xyz * ubo.ambientLightColor.w;
+    vec3 specularLight = vec3(0.0);
+
+    vec3 sunDirectionNorm = normalize(vec3(ubo.sunDirection));
+    float cosAngIncidence = max(dot(surfaceNormal, sunDirectionNorm), 0);
+    diffuseLight += cosAngIncidence * 0.5f;
+    // la pente filtrée perd les micro facettes, on élargit le lobe spéculaire en compensation
+    float specularPower = mix(256.0, 4096.0, weights.z);
+    vec3 halfAngleSun = normalize(sunDirectionNorm + viewDirection);
+    float blinnTermSun = clamp(dot(surfaceNormal, halfAngleSun) * 1.002f, 0, 1);
+    specularLight += pow(blinnTermSun, specularPower);
+
+    // une turbulence de 1 correspond à une mer sans écume
+    float foam = mix(1.0, texture(turbulence, worldUV / lengthScale1).x, weights.x) +
+                 mix(1.0, texture(turbulence2, worldUV / lengthScale2).x, weights.y) +
+                 mix(1.0, texture(turbulence3, worldUV / lengthScale3).x, weights.z);
+    foam = min(1.0, max(0.0, (-foam + 2.72) * 2));
+
+    float height = clamp((hitPosWorld.y - 0.15f) / 0.2f, 0.0, 1.0);
+    vec3 imageColor = mix(LIGHT_WATER_COLOR, DARK_WATER_COLOR, min(height + 0.6f, 1.f));
+    imageColor = mix(imageColor, vec3(1.0, 1.0, 1.0), foam);
+
+    outColor = vec4((diffuseLight * imageColor + specularLight * (imageColor + vec3(0.4f))), 0.98f);
+}
@@ -0,0 +1,24 @@
+#version 450
+// triangle plein écran placé juste devant le plan far : seuls les pixels laissés vides par la géométrie sont shadés
+const vec2 POSITIONS[3] = vec2[](vec2(-1.0, -1.0), vec2(3.0, -1.0), vec2(-1.0, 3.0));
+const float FAR_FIELD_DEPTH = 0.999999;
+
+layout(location = 0) out vec3 fragViewDirection;
+
+layout(set = 0, binding = 0) uniform GlobalUbo {
+    mat4 projection;
+    mat4 view;
+    mat4 invView;
+    vec4 sunDirection;
+    vec4 ambientLightColor;  // w is intensity
+    int numLights;
+}
+ubo;
+
+void main() {
+    vec2 ndc = POSITIONS[gl_VertexIndex];
+    // direction non normalisée à z = 1 en espace vue, elle s'interpole linéairement sur l'écran
+    vec3 viewDirection = vec3(ndc.x / ubo.projection[0][0], ndc.y / ubo.projection[1][1], 1.0);
+    fragViewDirection = mat3(ubo.invView) * viewDirection;
+    gl_Position = vec4(ndc, FAR_FIELD_DEPTH, 1.0);
+}
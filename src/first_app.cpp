@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <glm/ext/matrix_transform.hpp>
@@ -16,9 +17,15 @@
 #include "lve_camera.hpp"
 #include "lve_descriptor.hpp"
 #include "lve_device.hpp"
+#include "lve_frame_pacer.hpp"
 #include "lve_game_object.hpp"
+#include "lve_performance_governor.hpp"
+#include "lve_render_queue.hpp"
 #include "lve_swap_chain.hpp"
-#include "systems/computesSystems/shaderToySystem.hpp"
+#include "systems/computesSystems/cullingSystem.hpp"
+#include "systems/computesSystems/lightCullingSystem.hpp"
+#include "systems/computesSystems/pixelEffectSystem.hpp"
+#include "systems/computesSystems/volumetricCloudSystem.hpp"
 #include "systems/computesSystems/waveGenerationSystem.hpp"
 #include "systems/graphicsSystems/point_light_system.hpp"
 #include "systems/graphicsSystems/simple_render_system.hpp"
@@ -39,17 +46,22 @@
 
 namespace lve {
 
-FirstApp::FirstApp() {
+// ordre de FirstApp::PRESENT_MODE_TOGGLE_KEY
+static constexpr std::array<VkPresentModeKHR, 4> PRESENT_MODE_CYCLE = {
+    VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_MAILBOX_KHR,
+    VK_PRESENT_MODE_IMMEDIATE_KHR};
+
+FirstApp::FirstApp(const AppSettings &settings)
+    : lveRenderer{lveWindow, lveDevice, settings.postOutputMode, settings.framesInFlight, settings.presentMode},
+      targetFps{settings.targetFps},
+      pixelEffects{settings.pixelEffects} {
     globalPool = LveDescriptorPool::Builder(lveDevice)
-                     .setMaxSets(LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                     .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
+                     .setMaxSets(LveSwapChain::getFramesInFlight())
+                     .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, LveSwapChain::getFramesInFlight())
                      .build();
 
-    // Set default descriptor layout
-    std::shared_ptr<LveDescriptorSetLayout::Builder> setLayoutBuilder =
-        std::make_shared<LveDescriptorSetLayout::Builder>(lveDevice);
-    setLayoutBuilder->addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT);
-    LveDescriptorSetLayout::defaultTextureSetLayout = setLayoutBuilder->build();
+    // textures des objets, enregistrées une fois au chargement
+    textureTable = std::make_shared<LveTextureTable>(lveDevice);
 
     float boundary1 = 2 * M_PI / 17.f * 6.f;
     float boundary2 = 2 * M_PI / 5.f * 6.f;
@@ -61,7 +73,11 @@ FirstApp::FirstApp() {
     derivatives = waveGen2->getDerivatives();
     turbu = waveGen2->getTurbulence();
 
-    loadGameObjects();
+    if (settings.occlusionBenchmark) {
+        loadOcclusionBenchmark();
+    } else {
+        loadGameObjects();
+    }
 }
 
 FirstApp::~FirstApp() {}
@@ -70,7 +86,7 @@ void FirstApp::run() {
     std::cout << "FirstApp::run()" << std::endl;
 
     // Création des uniform buffer pour chaques frames
-    std::vector<std::unique_ptr<LveBuffer>> uboBuffers(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+    std::vector<std::unique_ptr<LveBuffer>> uboBuffers(LveSwapChain::getFramesInFlight());
     for (int i = 0; i < uboBuffers.size(); i++) {
         uboBuffers[i] = std::make_unique<LveBuffer>(lveDevice, sizeof(GlobalUbo), 1, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
                                                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
@@ -84,15 +100,19 @@ void FirstApp::run() {
                                .build();
 
     // Création des descriptor sets pour les uniform buffer
-    std::vector<VkDescriptorSet> globalDescriptorSets(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+    std::vector<VkDescriptorSet> globalDescriptorSets(LveSwapChain::getFramesInFlight());
     for (int i = 0; i < globalDescriptorSets.size(); i++) {
         auto bufferInfo = uboBuffers[i]->descriptorInfo();
         LveDescriptorWriter(*globalSetLayout, *globalPool).writeBuffer(0, &bufferInfo).build(globalDescriptorSets[i]);
     }
 
+    // clustering des point lights, produit les listes de lumières par froxel lues par les fragment shaders
+    std::shared_ptr<LightCullingSystem> lightCullingSystem =
+        std::make_shared<LightCullingSystem>(lveDevice, globalSetLayout->getDescriptorSetLayout());
+
     // initialisation du system de rendu des luimères
     PointLightSystem pointLightSystem{lveDevice, lveRenderer.getSwapChainRenderPass(),
-                                      globalSetLayout->getDescriptorSetLayout()};
+                                      globalSetLayout->getDescriptorSetLayout(), lightCullingSystem};
 
     WaterSystem WaterRenderSystem{lveDevice,
                                   lveRenderer.getSwapChainRenderPass(),
@@ -105,28 +125,49 @@ void FirstApp::run() {
                                   waveGen2->getAllTurbulence(),
                                   waveGen3->getAllDisplacement(),
                                   waveGen3->getAllDerivatives(),
-                                  waveGen3->getAllTurbulence()};
+                                  waveGen3->getAllTurbulence(),
+                                  lightCullingSystem};
+
+    // culling GPU des objets, produit les draw lists indirectes du rendu simple
+    std::shared_ptr<CullingSystem> cullingSystem =
+        std::make_shared<CullingSystem>(lveDevice, lveRenderer.getHiZPyramid());
 
     // initialisation du system de rendu simple
     SimpleRenderSystem simpleRenderSystem{lveDevice,
                                           lveRenderer.getSwapChainRenderPass(),
                                           globalSetLayout->getDescriptorSetLayout(),
-                                          LveDescriptorSetLayout::defaultTextureSetLayout->getDescriptorSetLayout(),
+                                          textureTable,
                                           WaterRenderSystem.getWaterTextureSetLayout(),
-                                          WaterRenderSystem.getDescriptorSets()};
+                                          WaterRenderSystem.getDescriptorSets(),
+                                          cullingSystem,
+                                          lightCullingSystem};
 
     SunSystem sunSystem{lveDevice, lveRenderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout(),
                         sun};
 
-    std::shared_ptr<ShaderToySystem> testToyShader = std::make_shared<ShaderToySystem>(
+    std::shared_ptr<VolumetricCloudSystem> cloudSystem = std::make_shared<VolumetricCloudSystem>(
         lveDevice, globalSetLayout->getDescriptorSetLayout(),
         LveDescriptorSetLayout::defaultPostProcessingTextureSetLayout->getDescriptorSetLayout(),
-        LveDescriptorSetLayout::depthTextureSetLayout->getDescriptorSetLayout());
-
-    lveRenderer.addPostProcessingEffect(testToyShader);
+        LveDescriptorSetLayout::linearDepthSetLayout->getDescriptorSetLayout(), CLOUD_RESOLUTION_DIVISOR);
+
+    lveRenderer.addPostProcessingEffect(cloudSystem);
+    if (pixelEffects) {
+        // effets par pixel consécutifs, fusionnés en un seul dispatch
+        // étalonnage x : exposition, y : contraste, z : saturation ; vignette x : intensité, y : rayon, z : fondu
+        lveRenderer.addPostProcessingEffect(std::make_shared<PixelEffectSystem>(
+            lveDevice, LveDescriptorSetLayout::defaultPostProcessingTextureSetLayout->getDescriptorSetLayout(),
+            LveDescriptorSetLayout::linearDepthSetLayout->getDescriptorSetLayout(), "color_grading",
+            glm::vec4{1.f, 1.05f, 1.1f, 0.f}));
+        lveRenderer.addPostProcessingEffect(std::make_shared<PixelEffectSystem>(
+            lveDevice, LveDescriptorSetLayout::defaultPostProcessingTextureSetLayout->getDescriptorSetLayout(),
+            LveDescriptorSetLayout::linearDepthSetLayout->getDescriptorSetLayout(), "vignette",
+            glm::vec4{0.35f, 0.45f, 0.5f, 0.f}));
+    }
     lveRenderer.addPreProcessingEffect(waveGen1);
     lveRenderer.addPreProcessingEffect(waveGen2);
     lveRenderer.addPreProcessingEffect(waveGen3);
+    lveRenderer.addPreProcessingEffect(cullingSystem);
+    lveRenderer.addPreProcessingEffect(lightCullingSystem);
     LveCamera camera{};
     // camera.setViewDirection(glm::vec3(0.f), glm::vec3(0.5, 0.f, 1.f));
     camera.setViewTarget(glm::vec3(-1.f, -2.f, 2.f), glm::vec3(0.f, 0.f, 2.5f));
@@ -135,12 +176,74 @@ void FirstApp::run() {
     viewerObject.transform.translation.z = -2.5f;
     KeyboardMouvementController cameraController{};
 
+    LvePerformanceGovernor performanceGovernor{GPU_FRAME_BUDGET_MS};
+    LveFramePacer framePacer{targetFps};
+    // réutilisée à chaque passe : les identifiants de pipeline des clés de tri restent stables
+    LveRenderQueue renderQueue{};
+
     auto currentTime = std::chrono::high_resolution_clock::now();
 
     int i = 0;
+    bool postOutputKeyDown = false;
+    bool presentModeKeyDown = false;
+    bool occlusionKeyDown = false;
+    bool occlusionCulling = true;
+    bool cloudNoiseKeyDown = false;
+    bool bakedCloudNoise = true;
+    cloudSystem->setBakedNoise(bakedCloudNoise);
+    // déclenche le premier affichage de la télémétrie dès la première frame
+    float statsPrintTimer = STATS_PRINT_INTERVAL;
+    // position dans PRESENT_MODE_CYCLE du mode demandé, le mode obtenu peut être FIFO
+    size_t presentModeIndex =
+        std::find(PRESENT_MODE_CYCLE.begin(), PRESENT_MODE_CYCLE.end(), lveRenderer.getPresentMode()) -
+        PRESENT_MODE_CYCLE.begin();
     while (!lveWindow.shouldClose()) {
+        framePacer.waitForNextFrame();
         glfwPollEvents();
 
+        // appliqué après la présentation de la frame, LvePostOutputStorage retombe sur la copie si non supporté
+        bool postOutputKeyPressed = glfwGetKey(lveWindow.getGLFWwindow(), POST_OUTPUT_TOGGLE_KEY) == GLFW_PRESS;
+        if (postOutputKeyPressed && !postOutputKeyDown) {
+            lveRenderer.setPostOutputMode(lveRenderer.getPostOutputMode() == LvePostOutputStorage
+                                              ? LvePostOutputCopy
+                                              : LvePostOutputStorage);
+        }
+        postOutputKeyDown = postOutputKeyPressed;
+
+        // appliqué après la présentation de la frame, comme la sortie du post-processing
+        bool presentModeKeyPressed = glfwGetKey(lveWindow.getGLFWwindow(), PRESENT_MODE_TOGGLE_KEY) == GLFW_PRESS;
+        if (presentModeKeyPressed && !presentModeKeyDown) {
+            presentModeIndex = (presentModeIndex + 1) % PRESENT_MODE_CYCLE.size();
+            lveRenderer.setPresentMode(PRESENT_MODE_CYCLE[presentModeIndex]);
+        }
+        presentModeKeyDown = presentModeKeyPressed;
+
+        // compare le culling frustum seul et avec occlusion dans la même exécution, les draw counts sont remis à zéro
+        // à chaque frame
+        bool occlusionKeyPressed = glfwGetKey(lveWindow.getGLFWwindow(), OCCLUSION_TOGGLE_KEY) == GLFW_PRESS;
+        if (occlusionKeyPressed && !occlusionKeyDown) {
+            occlusionCulling = !occlusionCulling;
+            cullingSystem->setOcclusionCulling(occlusionCulling);
+        }
+        occlusionKeyDown = occlusionKeyPressed;
+
+        // simple push constant des nuages, pris en compte dès cette frame
+        bool cloudNoiseKeyPressed = glfwGetKey(lveWindow.getGLFWwindow(), CLOUD_NOISE_TOGGLE_KEY) == GLFW_PRESS;
+        if (cloudNoiseKeyPressed && !cloudNoiseKeyDown) {
+            bakedCloudNoise = !bakedCloudNoise;
+            cloudSystem->setBakedNoise(bakedCloudNoise);
+        }
+        cloudNoiseKeyDown = cloudNoiseKeyPressed;
+
+        // réglages décidés par le governor avec la dernière mesure GPU
+        const QualitySettings &quality = performanceGovernor.getSettings();
+        lveRenderer.setRenderScale(quality.renderScale);
+        cloudSystem->setStepCount(quality.cloudSteps);
+        waveGen2->setUpdateInterval(quality.cascadeUpdateInterval);
+        waveGen3->setUpdateInterval(quality.cascadeUpdateInterval);
+        // les LOD sont choisis sur la résolution réellement rendue
+        cullingSystem->setViewportHeight(static_cast<float>(lveRenderer.getRenderExtent().height));
+
         auto newTime = std::chrono::high_resolution_clock::now();
         float frameTime = std::chrono::duration<float, std::chrono::seconds::period>(newTime - currentTime).count();
         currentTime = newTime;
@@ -149,9 +252,6 @@ void FirstApp::run() {
         cameraController.moveInPlaneXZ(lveWindow.getGLFWwindow(), frameTime, viewerObject);
 
         camera.setViewYXZ(viewerObject.transform.translation, viewerObject.transform.rotation);
-        // change horizontal position of the water
-        gameObjects.at(waterId).transform.translation.z = viewerObject.transform.translation.z * 2.f;
-        gameObjects.at(waterId).transform.translation.x = viewerObject.transform.translation.x * 2.f;
         glm::vec3 sunDirection = glm::normalize(glm::vec3(-1.0f, -1.0f, -1.0f));
         float distanceFromCamera = 50.0f;
         glm::vec3 sunPosition = viewerObject.transform.translation + distanceFromCamera * sunDirection;
@@ -164,15 +264,42 @@ void FirstApp::run() {
         float aspect = lveRenderer.getAspectRatio();
         camera.setOrthographicProjection(-aspect, aspect, -1, 1, -1, 1);
         camera.setPerspectiveProjection(glm::radians(80.f), aspect, 0.1f, 100.f);
-        if (lveRenderer.startRendering(syncObjects)) {
-            VkCommandBuffer commandBuffer = lveRenderer.beginFrame(syncObjects);
+        if (lveRenderer.startRendering()) {
+            VkCommandBuffer commandBuffer = lveRenderer.beginFrame();
             int frameIndex = lveRenderer.getFrameIndex();
             int swapChainImageIndex = lveRenderer.getSwapchainFrameIndex();
             i = i + 1;
 
+            float gpuTimeMs;
+            if (lveRenderer.getGpuFrameTime(gpuTimeMs)) {
+                performanceGovernor.update(gpuTimeMs);
+            }
+
             std::cout << "Frame time: " << frameTime << " seconds" << std::endl;
             std::cout << "frame per second :" << 1.f / frameTime << std::endl;
-            std::cout << "\033[2A";
+            // la télémétrie reste affichée sous les deux lignes de la frame, réécrite à intervalle régulier
+            statsPrintTimer += frameTime;
+            if (statsPrintTimer >= STATS_PRINT_INTERVAL) {
+                statsPrintTimer = 0.f;
+                const GovernorTelemetry &telemetry = performanceGovernor.getTelemetry();
+                std::cout << "GPU: " << telemetry.smoothedGpuTimeMs << " ms / " << telemetry.budgetMs
+                          << " ms | qualite " << telemetry.qualityLevel << " (echelle "
+                          << telemetry.settings.renderScale << ", pas " << telemetry.settings.cloudSteps
+                          << ", cascades 1/" << telemetry.settings.cascadeUpdateInterval << ") | decisions "
+                          << telemetry.decisionCount << " | sortie "
+                          << (lveRenderer.getPostOutputMode() == LvePostOutputStorage ? "storage" : "copie")
+                          << " | culling " << (occlusionCulling ? "hi-z" : "frustum") << " | bruit "
+                          << (bakedCloudNoise ? "precalcule" : "procedural") << "   " << std::endl;
+                const FramePacingStats &pacing = framePacer.getStats();
+                // intervalles mesurés sur le CPU au retour de vkQueuePresentKHR, pas à l'affichage
+                std::cout << "Present: " << LveSwapChain::presentModeName(lveRenderer.getPresentMode())
+                          << " | intervalle CPU " << pacing.meanIntervalMs << " ms, ecart-type "
+                          << pacing.intervalStdDevMs << " ms, max " << pacing.maxIntervalMs << " ms | limite "
+                          << framePacer.getTargetFps() << " fps   " << std::endl;
+                std::cout << "\033[4A";
+            } else {
+                std::cout << "\033[2A";
+            }
             FrameInfo frameInfo{frameIndex,
                                 swapChainImageIndex,
                                 frameTime,
@@ -181,10 +308,10 @@ void FirstApp::run() {
                                 lveRenderer.getPostProcessingCommandBuffer(),
                                 camera,
                                 globalDescriptorSets[frameIndex],
-                                gameObjects};
+                                gameObjects,
+                                lveRenderer.getRenderScale()};
 
-            lveRenderer.executePreProssessingEffects(frameInfo, syncObjects);
-            // update
+            // update, avant le pre-processing qui lit l'ubo et les lumières
             GlobalUbo ubo{};
 
             ubo.projection = camera.getProjection();
@@ -195,18 +322,34 @@ void FirstApp::run() {
             uboBuffers[frameIndex]->writeToBuffer(&ubo);
             uboBuffers[frameIndex]->flush();
 
-            // render
-            lveRenderer.beginSwapChainRenderPass(commandBuffer);
+            lveRenderer.executePreProssessingEffects(frameInfo);
 
-            // order here
-            simpleRenderSystem.renderGameObjects(frameInfo);
-            WaterRenderSystem.renderGameObjects(frameInfo);
-            pointLightSystem.render(frameInfo);
-            sunSystem.render(frameInfo);
+            // render, les systèmes soumettent leurs paquets, l'ordre de dessin vient des clés de tri
+            lveRenderer.beginSwapChainRenderPass(commandBuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+            // première passe : objets visibles à la frame précédente + océan, qui remplissent le depth buffer
+            renderQueue.clear();
+            simpleRenderSystem.submit(frameInfo, CullingPhaseEarly, renderQueue);
+            WaterRenderSystem.submit(frameInfo, renderQueue);
+            lveRenderer.recordRenderQueue(frameInfo, renderQueue);
+            lveRenderer.endSwapChainRenderPass(commandBuffer);
+
+            // pyramide Hi-Z de cette frame, utilisée par la phase late puis par la phase early de la frame suivante
+            lveRenderer.buildDepthPyramid(commandBuffer);
+            cullingSystem->executeLateCulling(frameInfo);
+
+            // seconde passe : objets rejetés à tort par la phase early
+            lveRenderer.resumeSwapChainRenderPass(commandBuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            renderQueue.clear();
+            simpleRenderSystem.submit(frameInfo, CullingPhaseLate, renderQueue);
+            pointLightSystem.submit(frameInfo, renderQueue);
+            sunSystem.submit(frameInfo, renderQueue);
+            lveRenderer.recordRenderQueue(frameInfo, renderQueue);
             lveRenderer.endSwapChainRenderPass(commandBuffer);
-            lveRenderer.endFrame(syncObjects);
-            lveRenderer.renderPostProssessingEffects(frameInfo, syncObjects);
-            lveRenderer.presentFrame(syncObjects);
+            lveRenderer.endFrame();
+            lveRenderer.renderPostProssessingEffects(frameInfo);
+            lveRenderer.presentFrame();
+            framePacer.framePresented();
         }
     }
 
@@ -222,11 +365,12 @@ void FirstApp::loadGameObjects() {
     // flatVase.transform.rotation = {0.f, glm::radians(90.f), 0.f};
     // gameObjects.emplace(flatVase.getId(), std::move(flatVase));
 
-    std::shared_ptr<LveModel> lveModel = LveModel::createModelFromFile(lveDevice, "models/Rubber Duck jaune.obj");
+    std::shared_ptr<LveModel> lveModel = LveModel::createModelFromFile(lveDevice, "models/Rubber Duck jaune.obj",
+                                                                           LveVertexFormatCompressed);
     std::shared_ptr<LveTexture> lveTexture = std::make_unique<LveTexture>(lveDevice, "textures/Rubber_Duck.png", false);
     auto coin = LveGameObject::createGameObject();
-    (*lveModel).createDescriptorSet(lveDevice, lveTexture.get(), nullptr);
     coin.texture = lveTexture;
+    coin.textureIndex = textureTable->registerTexture(lveTexture);
     coin.model = lveModel;
     coin.transform.translation = {.5f, 0.35f, 0.0f};
     coin.transform.scale = {0.15f, 0.15f, 0.15f};
@@ -235,7 +379,7 @@ void FirstApp::loadGameObjects() {
 
     // std::shared_ptr<LveModel> lveModel = LveModel::createModelFromFile(lveDevice, "models/quad.obj");
     // auto floor = LveGameObject::createGameObject();
-    // (*lveModel).createDescriptorSet(lveDevice, display.get(), nullptr);
+    // floor.textureIndex = textureTable->registerTexture(display);
     // floor.model = lveModel;
     // floor.texture = display;
     // floor.transform.translation = {0.f, .5f, -8.f};
@@ -244,7 +388,7 @@ void FirstApp::loadGameObjects() {
 
     // lveModel = LveModel::createModelFromFile(lveDevice, "models/quad.obj");
     // floor = LveGameObject::createGameObject();
-    // (*lveModel).createDescriptorSet(lveDevice, derivatives.get(), nullptr);
+    // floor.textureIndex = textureTable->registerTexture(derivatives);
     // floor.model = lveModel;
     // floor.texture = derivatives;
     // floor.transform.translation = {8.f, .5f, 0.f};
@@ -253,16 +397,15 @@ void FirstApp::loadGameObjects() {
 
     // lveModel = LveModel::createModelFromFile(lveDevice, "models/quad.obj");
     // floor = LveGameObject::createGameObject();
-    // (*lveModel).createDescriptorSet(lveDevice, turbu.get(), nullptr);
+    // floor.textureIndex = textureTable->registerTexture(turbu);
     // floor.model = lveModel;
     // floor.texture = turbu;
     // floor.transform.translation = {0.f, .5f, 8.f};
     // floor.transform.scale = {3.f, 1.f, 3.f};
     // gameObjects.emplace(floor.getId(), std::move(floor));
 
-    lveModel = LveModel::createModelFromFile(lveDevice, "models/ocean.obj");
+    // la grille de l'océan est générée par water.vert autour de la caméra
     auto floor = LveGameObject::createGameObject();
-    floor.model = lveModel;
     floor.water = std::make_unique<Water>();
     floor.transform.translation = {0.f, .5f, 0.f};
     floor.transform.scale = {1.f, 1.f, 1.f};
@@ -274,7 +417,7 @@ void FirstApp::loadGameObjects() {
 
     // lveModel = LveModel::createModelFromFile(lveDevice, "models/quad.obj");
     // auto test = LveGameObject::createGameObject();
-    // (*lveModel).createDescriptorSet(lveDevice, texturedst.get(), nullptr);
+    // test.textureIndex = textureTable->registerTexture(texturedst);
     // test.model = lveModel;
     // test.texture = texturedst;
     // test.transform.translation = {0.f, -1.5f, 0.f};
@@ -298,4 +441,43 @@ void FirstApp::loadGameObjects() {
 
     // using pointlight again invalid
 }
+
+void FirstApp::loadOcclusionBenchmark() {
+    // grille de canards cachée derrière un mur : presque tout doit être rejeté par le test d'occlusion
+    std::shared_ptr<LveModel> duckModel =
+        LveModel::createModelFromFile(lveDevice, "models/Rubber Duck jaune.obj", LveVertexFormatCompressed);
+    std::shared_ptr<LveTexture> duckTexture = std::make_unique<LveTexture>(lveDevice, "textures/Rubber_Duck.png", false);
+    uint32_t duckTextureIndex = textureTable->registerTexture(duckTexture);
+    for (int x = 0; x < 60; x++) {
+        for (int z = 0; z < 60; z++) {
+            auto duck = LveGameObject::createGameObject();
+            duck.texture = duckTexture;
+            duck.textureIndex = duckTextureIndex;
+            duck.model = duckModel;
+            duck.transform.translation = {(x - 30) * 0.6f, 0.35f, 4.f + z * 0.6f};
+            duck.transform.scale = {0.15f, 0.15f, 0.15f};
+            duck.transform.rotation = {0.f, glm::radians(180.f), glm::radians(180.f)};
+            gameObjects.emplace(duck.getId(), std::move(duck));
+        }
+    }
+
+    std::shared_ptr<LveModel> wallModel =
+        LveModel::createModelFromFile(lveDevice, "models/cube.obj", LveVertexFormatCompressed);
+    std::shared_ptr<LveTexture> wallTexture = std::make_unique<LveTexture>(lveDevice, "textures/texture.jpg", false);
+    auto wall = LveGameObject::createGameObject();
+    wall.texture = wallTexture;
+    wall.textureIndex = textureTable->registerTexture(wallTexture);
+    wall.model = wallModel;
+    wall.transform.translation = {0.f, -2.f, 2.f};
+    wall.transform.scale = {40.f, 6.f, 0.2f};
+    gameObjects.emplace(wall.getId(), std::move(wall));
+
+    auto floor = LveGameObject::createGameObject();
+    floor.water = std::make_unique<Water>();
+    floor.transform.translation = {0.f, .5f, 0.f};
+    waterId = floor.getId();
+    gameObjects.emplace(floor.getId(), std::move(floor));
+
+    sun = std::make_shared<LveGameObject>(LveGameObject::createGameObject());
+}
 }  // namespace lve
\ No newline at end of file
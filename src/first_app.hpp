@@ -9,17 +9,48 @@
 #include "lve_device.hpp"
 #include "lve_game_object.hpp"
 #include "lve_renderer.hpp"
+#include "lve_swap_chain.hpp"
 #include "lve_texture.hpp"
+#include "lve_texture_table.hpp"
 #include "lve_utils.hpp"
 #include "lve_window.hpp"
 #include "systems/computesSystems/waveGenerationSystem.hpp"
 namespace lve {
+// réglages choisis au lancement en ligne de commande, voir main.cpp
+struct AppSettings {
+    int framesInFlight = LveSwapChain::DEFAULT_FRAMES_IN_FLIGHT;
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR;  // changé ensuite avec PRESENT_MODE_TOGGLE_KEY
+    float targetFps = 0.f;  // limite de la boucle de rendu, 0 sans limite
+    // copie finale ou écriture directe du dernier effet dans la swapchain, POST_OUTPUT_TOGGLE_KEY bascule entre les
+    // deux en cours d'exécution pour les comparer avec le temps GPU affiché
+    LvePostOutputMode postOutputMode = LvePostOutputCopy;
+    // ajoute l'étalonnage et la vignette après les nuages, fusionnés en un seul dispatch. Change l'image : la chaîne
+    // par défaut reste celle des nuages seuls
+    bool pixelEffects = false;
+    // remplace la scène par un mur devant une grille de canards pour mesurer le culling d'occlusion
+    bool occlusionBenchmark = false;
+};
+
 class FirstApp {
    public:
     static constexpr int WIDTH = 1280;
     static constexpr int HEIGHT = 720;
+    // active ou coupe le test d'occlusion Hi-Z, le culling se limite alors au frustum
+    static constexpr int OCCLUSION_TOGGLE_KEY = GLFW_KEY_H;
+    // budget de temps GPU tenu par le LvePerformanceGovernor
+    static constexpr float GPU_FRAME_BUDGET_MS = 1000.f / 60.f;
+    // secondes entre deux affichages de la télémétrie du governor et du pacer dans la console
+    static constexpr float STATS_PRINT_INTERVAL = 1.f;
+    // voir AppSettings::postOutputMode
+    static constexpr int POST_OUTPUT_TOGGLE_KEY = GLFW_KEY_O;
+    // passe au mode de présentation suivant (fifo, fifo_relaxed, mailbox, immediate), FIFO si non supporté
+    static constexpr int PRESENT_MODE_TOGGLE_KEY = GLFW_KEY_P;
+    // 2 : nuages en demi résolution, 4 : en quart de résolution
+    static constexpr uint32_t CLOUD_RESOLUTION_DIVISOR = 2;
+    // bascule le bruit des nuages entre le volume précalculé (par défaut) et le bruit procédural, pour comparer
+    static constexpr int CLOUD_NOISE_TOGGLE_KEY = GLFW_KEY_N;
 
-    FirstApp();
+    FirstApp(const AppSettings &settings = {});
     ~FirstApp();
 
     FirstApp(const LveWindow &) = delete;
@@ -28,14 +59,17 @@ class FirstApp {
 
    private:
     void loadGameObjects();
+    void loadOcclusionBenchmark();
 
     LveWindow lveWindow{WIDTH, HEIGHT, "TutournesEgine v0.1"};
     LveDevice lveDevice{lveWindow};
-    LveRenderer lveRenderer{lveWindow, lveDevice};
-    SynchronisationObjects syncObjects;
+    LveRenderer lveRenderer;
+    float targetFps;
+    bool pixelEffects;
 
     // l'ordre de déclaration compte
     std::unique_ptr<LveDescriptorPool> globalPool{};
+    std::shared_ptr<LveTextureTable> textureTable;
     std::shared_ptr<LveTexture> display;
     std::shared_ptr<LveTexture> derivatives;
     std::shared_ptr<LveTexture> turbu;
@@ -44,8 +44,11 @@ LveBuffer::LveBuffer(LveDevice &device, VkDeviceSize instanceSize, uint32_t inst
 
 LveBuffer::~LveBuffer() {
     unmap();
-    vkDestroyBuffer(lveDevice.device(), buffer, nullptr);
-    vkFreeMemory(lveDevice.device(), memory, nullptr);
+    // les frames en vol peuvent encore lire le buffer
+    lveDevice.retire([&device = lveDevice, buffer = buffer, memory = memory]() {
+        vkDestroyBuffer(device.device(), buffer, nullptr);
+        vkFreeMemory(device.device(), memory, nullptr);
+    });
 }
 
 /**
@@ -21,8 +21,11 @@ LveCPipeline::LveCPipeline(LveDevice &device, const std::string &computeFilepath
 }
 
 LveCPipeline::~LveCPipeline() {
-    vkDestroyShaderModule(lveDevice.device(), computeShaderModule, nullptr);
-    vkDestroyPipeline(lveDevice.device(), computePipeLine, nullptr);
+    // le pipeline peut encore être utilisé par les command buffers des frames en vol
+    lveDevice.retire([&device = lveDevice, shaderModule = computeShaderModule, pipeline = computePipeLine]() {
+        vkDestroyShaderModule(device.device(), shaderModule, nullptr);
+        vkDestroyPipeline(device.device(), pipeline, nullptr);
+    });
 }
 
 std::vector<char> LveCPipeline::readFile(const std::string &filepath) {
@@ -8,10 +8,9 @@
 
 namespace lve {
 
-std::unique_ptr<LveDescriptorSetLayout> LveDescriptorSetLayout::defaultTextureSetLayout;
 std::unique_ptr<LveDescriptorSetLayout> LveDescriptorSetLayout::defaultPostProcessingTextureSetLayout;
 
-std::unique_ptr<LveDescriptorSetLayout> LveDescriptorSetLayout::depthTextureSetLayout;
+std::unique_ptr<LveDescriptorSetLayout> LveDescriptorSetLayout::linearDepthSetLayout;
 
 // *************** Descriptor Set Layout Builder *********************
 
@@ -29,24 +28,48 @@ LveDescriptorSetLayout::Builder &LveDescriptorSetLayout::Builder::addBinding(uin
     return *this;
 }
 
+LveDescriptorSetLayout::Builder &LveDescriptorSetLayout::Builder::setBindingFlags(uint32_t binding,
+                                                                                  VkDescriptorBindingFlags flags) {
+    assert(bindings.count(binding) == 1 && "Binding flags set on an unknown binding");
+    bindingFlags[binding] = flags;
+    return *this;
+}
+
 std::unique_ptr<LveDescriptorSetLayout> LveDescriptorSetLayout::Builder::build() const {
-    return std::make_unique<LveDescriptorSetLayout>(lveDevice, bindings);
+    return std::make_unique<LveDescriptorSetLayout>(lveDevice, bindings, bindingFlags);
 }
 
 // *************** Descriptor Set Layout *********************
 
 LveDescriptorSetLayout::LveDescriptorSetLayout(LveDevice &lveDevice,
-                                               std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings)
+                                               std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings,
+                                               std::unordered_map<uint32_t, VkDescriptorBindingFlags> bindingFlags)
     : lveDevice{lveDevice}, bindings{bindings} {
     std::vector<VkDescriptorSetLayoutBinding> setLayoutBindings{};
+    std::vector<VkDescriptorBindingFlags> setLayoutBindingFlags{};
+    bool updateAfterBind = false;
     for (auto kv : bindings) {
         setLayoutBindings.push_back(kv.second);
+        auto flags = bindingFlags.find(kv.first);
+        setLayoutBindingFlags.push_back(flags == bindingFlags.end() ? 0 : flags->second);
+        updateAfterBind |= (setLayoutBindingFlags.back() & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT) != 0;
     }
 
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = static_cast<uint32_t>(setLayoutBindingFlags.size());
+    bindingFlagsInfo.pBindingFlags = setLayoutBindingFlags.data();
+
     VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo{};
     descriptorSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     descriptorSetLayoutInfo.bindingCount = static_cast<uint32_t>(setLayoutBindings.size());
     descriptorSetLayoutInfo.pBindings = setLayoutBindings.data();
+    if (!bindingFlags.empty()) {
+        descriptorSetLayoutInfo.pNext = &bindingFlagsInfo;
+    }
+    if (updateAfterBind) {
+        descriptorSetLayoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    }
 
     if (vkCreateDescriptorSetLayout(lveDevice.device(), &descriptorSetLayoutInfo, nullptr, &descriptorSetLayout) !=
         VK_SUCCESS) {
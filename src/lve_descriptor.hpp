@@ -19,24 +19,26 @@ class LveDescriptorSetLayout {
 
         Builder &addBinding(uint32_t binding, VkDescriptorType descriptorType, VkShaderStageFlags stageFlags,
                             uint32_t count = 1);
+        // flags de descriptor indexing (partially bound, update after bind...) d'un binding déjà ajouté
+        Builder &setBindingFlags(uint32_t binding, VkDescriptorBindingFlags flags);
         std::unique_ptr<LveDescriptorSetLayout> build() const;
 
        private:
         LveDevice &lveDevice;
         std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings{};
+        std::unordered_map<uint32_t, VkDescriptorBindingFlags> bindingFlags{};
     };
 
-    LveDescriptorSetLayout(LveDevice &lveDevice, std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings);
+    LveDescriptorSetLayout(LveDevice &lveDevice, std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings,
+                           std::unordered_map<uint32_t, VkDescriptorBindingFlags> bindingFlags = {});
     ~LveDescriptorSetLayout();
     LveDescriptorSetLayout(const LveDescriptorSetLayout &) = delete;
     LveDescriptorSetLayout &operator=(const LveDescriptorSetLayout &) = delete;
 
     VkDescriptorSetLayout getDescriptorSetLayout() const { return descriptorSetLayout; }
 
-    static std::unique_ptr<lve::LveDescriptorSetLayout> defaultTextureSetLayout;
-
     static std::unique_ptr<lve::LveDescriptorSetLayout> defaultPostProcessingTextureSetLayout;
-    static std::unique_ptr<lve::LveDescriptorSetLayout> depthTextureSetLayout;
+    static std::unique_ptr<lve::LveDescriptorSetLayout> linearDepthSetLayout;
 
    private:
     LveDevice &lveDevice;
@@ -68,6 +68,16 @@ namespace lve
 
   LveDevice::~LveDevice()
   {
+    vkDeviceWaitIdle(device_);
+    // détruits immédiatement, y compris ceux retirés par un deleter
+    frameStarted = false;
+    while (!retiredResources.empty())
+    {
+      RetiredResource retiredResource = std::move(retiredResources.front());
+      retiredResources.pop_front();
+      retiredResource.deleter();
+    }
+
     vkDestroyCommandPool(device_, commandPool, nullptr);
     vkDestroyDevice(device_, nullptr);
 
@@ -93,7 +103,7 @@ namespace lve
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName = "No Engine";
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    appInfo.apiVersion = VK_API_VERSION_1_2;
 
     VkInstanceCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -180,16 +190,41 @@ namespace lve
 
     VkPhysicalDeviceFeatures deviceFeatures = {};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
+    // draw lists compactées par le culling GPU
+    deviceFeatures.multiDrawIndirect = VK_TRUE;
+    deviceFeatures.drawIndirectFirstInstance = VK_TRUE;
+
+    VkPhysicalDeviceVulkan12Features vulkan12Features = {};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.drawIndirectCount = VK_TRUE;
+    // table de textures bindless (LveTextureTable)
+    vulkan12Features.descriptorIndexing = VK_TRUE;
+    vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+    vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+    vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    // synchronisation des frames (LveFrameSync)
+    vulkan12Features.timelineSemaphore = VK_TRUE;
 
     VkDeviceCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &vulkan12Features;
 
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
+    // extension facultative : images de swapchain écrites par le post-processing comme storage images
+    std::vector<const char *> enabledExtensions = deviceExtensions;
+    swapchainMutableFormatSupported =
+        checkOptionalDeviceExtensionSupport(physicalDevice, VK_KHR_SWAPCHAIN_MUTABLE_FORMAT_EXTENSION_NAME);
+    if (swapchainMutableFormatSupported)
+    {
+      enabledExtensions.push_back(VK_KHR_SWAPCHAIN_MUTABLE_FORMAT_EXTENSION_NAME);
+    }
+
     createInfo.pEnabledFeatures = &deviceFeatures;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+    createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
     // might not really be necessary anymore because device specific validation layers
     // have been deprecated
@@ -230,6 +265,23 @@ namespace lve
     }
   }
 
+  VkCommandPool LveDevice::createCommandPool(VkCommandPoolCreateFlags flags)
+  {
+    QueueFamilyIndices queueFamilyIndices = findPhysicalQueueFamilies();
+
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsAndComputeFamily;
+    poolInfo.flags = flags;
+
+    VkCommandPool pool;
+    if (vkCreateCommandPool(device_, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+    {
+      throw std::runtime_error("failed to create command pool!");
+    }
+    return pool;
+  }
+
   void LveDevice::createSurface() { window.createWindowSurface(instance, &surface_); }
 
   bool LveDevice::isDeviceSuitable(VkPhysicalDevice device)
@@ -245,11 +297,21 @@ namespace lve
       swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
     }
 
-    VkPhysicalDeviceFeatures supportedFeatures;
-    vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
+    VkPhysicalDeviceVulkan12Features supportedVulkan12Features = {};
+    supportedVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceFeatures2 supportedFeatures = {};
+    supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supportedFeatures.pNext = &supportedVulkan12Features;
+    vkGetPhysicalDeviceFeatures2(device, &supportedFeatures);
 
     return indices.isComplete() && extensionsSupported && swapChainAdequate &&
-           supportedFeatures.samplerAnisotropy;
+           supportedFeatures.features.samplerAnisotropy && supportedFeatures.features.multiDrawIndirect &&
+           supportedFeatures.features.drawIndirectFirstInstance && supportedVulkan12Features.drawIndirectCount &&
+           supportedVulkan12Features.descriptorIndexing && supportedVulkan12Features.runtimeDescriptorArray &&
+           supportedVulkan12Features.shaderSampledImageArrayNonUniformIndexing &&
+           supportedVulkan12Features.descriptorBindingPartiallyBound &&
+           supportedVulkan12Features.descriptorBindingSampledImageUpdateAfterBind &&
+           supportedVulkan12Features.timelineSemaphore;
   }
 
   void LveDevice::populateDebugMessengerCreateInfo(
@@ -373,6 +435,24 @@ namespace lve
     return requiredExtensions.empty();
   }
 
+  bool LveDevice::checkOptionalDeviceExtensionSupport(VkPhysicalDevice device, const char *extensionName)
+  {
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+    for (const auto &extension : availableExtensions)
+    {
+      if (strcmp(extension.extensionName, extensionName) == 0)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
   QueueFamilyIndices LveDevice::findQueueFamilies(VkPhysicalDevice device)
   {
     QueueFamilyIndices indices;
@@ -543,12 +623,55 @@ namespace lve
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    vkQueueSubmit(graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue_);
+    // fence plutôt que vkQueueWaitIdle : seule cette soumission est attendue, pas les frames en vol
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkFence fence;
+    if (vkCreateFence(device_, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+    {
+      throw std::runtime_error("failed to create single time command fence!");
+    }
+
+    vkQueueSubmit(graphicsQueue_, 1, &submitInfo, fence);
+    vkWaitForFences(device_, 1, &fence, VK_TRUE, UINT64_MAX);
+    vkDestroyFence(device_, fence, nullptr);
 
     vkFreeCommandBuffers(device_, commandPool, 1, &commandBuffer);
   }
 
+  void LveDevice::retire(std::function<void()> deleter)
+  {
+    std::unique_lock<std::mutex> lock{retiredResourcesMutex};
+    if (!frameStarted)
+    {
+      lock.unlock();
+      deleter();
+      return;
+    }
+    retiredResources.push_back({currentFrame, std::move(deleter)});
+  }
+
+  void LveDevice::beginFrame(uint64_t frame, uint64_t completedFrames)
+  {
+    std::deque<RetiredResource> completed;
+    {
+      std::lock_guard<std::mutex> lock{retiredResourcesMutex};
+      currentFrame = frame;
+      frameStarted = true;
+      while (!retiredResources.empty() && retiredResources.front().frame < completedFrames)
+      {
+        completed.push_back(std::move(retiredResources.front()));
+        retiredResources.pop_front();
+      }
+    }
+
+    // hors du verrou : un deleter peut lui-même retirer d'autres ressources
+    for (auto &retiredResource : completed)
+    {
+      retiredResource.deleter();
+    }
+  }
+
   void LveDevice::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
   {
     VkCommandBuffer commandBuffer = beginSingleTimeCommands();
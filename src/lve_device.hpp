@@ -3,6 +3,10 @@
 #include "lve_window.hpp"
 
 // std lib headers
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -41,6 +45,8 @@ class LveDevice {
     LveDevice &operator=(LveDevice &&) = delete;
 
     VkCommandPool getCommandPool() { return commandPool; }
+    // pool supplémentaire pour enregistrer des command buffers depuis un autre thread, à détruire par l'appelant
+    VkCommandPool createCommandPool(VkCommandPoolCreateFlags flags);
     VkDevice device() { return device_; }
     VkSurfaceKHR surface() { return surface_; }
     VkQueue graphicsQueue() { return graphicsQueue_; }
@@ -53,6 +59,7 @@ class LveDevice {
                                  VkFormatFeatureFlags features);
 
     VkPhysicalDevice getPhysicalDevice() { return physicalDevice; }
+    bool supportsSwapchainMutableFormat() const { return swapchainMutableFormatSupported; }
 
     // Buffer Helper Functions
     void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer,
@@ -70,6 +77,14 @@ class LveDevice {
     void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount,
                            VkImageLayout imageLayout);
 
+    // destruction différée : deleter est appelé quand les frames déjà commencées sont terminées sur le GPU, ce qui
+    // permet de remplacer une ressource encore lue par les frames en vol sans vkDeviceWaitIdle. Utilisée par les
+    // destructeurs de LveBuffer, LveTexture et des pipelines, appelable depuis n'importe quel thread
+    void retire(std::function<void()> deleter);
+    // appelée par le renderer au début de la frame frame : les frames d'indice inférieur à completedFrames sont
+    // terminées sur le GPU
+    void beginFrame(uint64_t frame, uint64_t completedFrames);
+
    private:
     void createInstance();
     void setupDebugMessenger();
@@ -86,6 +101,7 @@ class LveDevice {
     void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT &createInfo);
     void hasGflwRequiredInstanceExtensions();
     bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+    bool checkOptionalDeviceExtensionSupport(VkPhysicalDevice device, const char *extensionName);
     SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
 
     VkInstance instance;
@@ -98,6 +114,17 @@ class LveDevice {
     VkSurfaceKHR surface_;
     VkQueue graphicsQueue_;
     VkQueue presentQueue_;
+    bool swapchainMutableFormatSupported = false;
+
+    struct RetiredResource {
+        uint64_t frame;  // dernière frame pouvant utiliser la ressource
+        std::function<void()> deleter;
+    };
+    std::deque<RetiredResource> retiredResources;
+    std::mutex retiredResourcesMutex;
+    uint64_t currentFrame = 0;
+    // avant la première frame, seules les commandes à usage unique ont touché le GPU et elles sont déjà attendues
+    bool frameStarted = false;
 
     const std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation"};
     const std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
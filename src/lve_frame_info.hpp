@@ -8,10 +8,9 @@
 
 namespace lve {
 
-#define MAX_LIGHTS 10
-
+// doit correspondre à PointLight dans light_culling.comp (std430)
 struct PointLight {
-    glm::vec4 position{};  // ignore w
+    glm::vec4 position{};  // w is range
     glm::vec4 color{};     // w is intensity
 };
 
@@ -21,8 +20,7 @@ struct GlobalUbo {
     glm::mat4 inverseView{1.f};
     glm::vec4 sunDirection{0.f, -1.f, 0.f, 1.f};
     glm::vec4 ambientLightColor{1.f, 1.f, 1.f, .02f};  // w is intensity
-    PointLight pointLights[MAX_LIGHTS];
-    int numLights;
+    int numLights;  // les lumières sont dans le buffer de LightCullingSystem
 };
 
 struct FrameInfo {
@@ -35,6 +33,8 @@ struct FrameInfo {
     LveCamera &camera;
     VkDescriptorSet globalDescriptorSet;
     LveGameObject::Map &gameObjects;
+    // fraction de la swapchain couverte par la scène, voir LveRenderer::setRenderScale
+    float renderScale = 1.f;
 };
 
 }  // namespace lve
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "lve_frame_pacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace lve {
+
+LveFramePacer::LveFramePacer(float targetFps) { setTargetFps(targetFps); }
+
+void LveFramePacer::setTargetFps(float fps) {
+    targetFps = std::max(fps, 0.f);
+    framePeriod = targetFps > 0.f
+                      ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps))
+                      : Clock::duration::zero();
+    nextFrameTimeValid = false;
+}
+
+void LveFramePacer::waitForNextFrame() {
+    if (framePeriod == Clock::duration::zero()) return;
+
+    Clock::time_point now = Clock::now();
+    if (!nextFrameTimeValid || now - nextFrameTime > framePeriod) {
+        nextFrameTime = now;
+        nextFrameTimeValid = true;
+    }
+
+    auto spinThreshold =
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(SPIN_THRESHOLD_MS));
+    if (nextFrameTime - now > spinThreshold) {
+        std::this_thread::sleep_for(nextFrameTime - now - spinThreshold);
+    }
+    while (Clock::now() < nextFrameTime) {
+        std::this_thread::yield();
+    }
+    nextFrameTime += framePeriod;
+}
+
+void LveFramePacer::framePresented() {
+    Clock::time_point now = Clock::now();
+    if (presented) {
+        intervals[nextInterval] = std::chrono::duration<float, std::milli>(now - lastPresentTime).count();
+        nextInterval = (nextInterval + 1) % STATS_WINDOW;
+        intervalCount = std::min(intervalCount + 1, STATS_WINDOW);
+        updateStats();
+    }
+    lastPresentTime = now;
+    presented = true;
+}
+
+void LveFramePacer::updateStats() {
+    float sum = 0.f;
+    float minInterval = intervals[0];
+    float maxInterval = intervals[0];
+    for (size_t i = 0; i < intervalCount; i++) {
+        sum += intervals[i];
+        minInterval = std::min(minInterval, intervals[i]);
+        maxInterval = std::max(maxInterval, intervals[i]);
+    }
+    float mean = sum / static_cast<float>(intervalCount);
+
+    float variance = 0.f;
+    for (size_t i = 0; i < intervalCount; i++) {
+        float delta = intervals[i] - mean;
+        variance += delta * delta;
+    }
+    variance /= static_cast<float>(intervalCount);
+
+    stats.sampleCount = static_cast<uint32_t>(intervalCount);
+    stats.meanIntervalMs = mean;
+    stats.intervalVariance = variance;
+    stats.intervalStdDevMs = std::sqrt(variance);
+    stats.minIntervalMs = minInterval;
+    stats.maxIntervalMs = maxInterval;
+}
+}  // namespace lve
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace lve {
+
+// intervalles entre deux retours de vkQueuePresentKHR sur les STATS_WINDOW dernières frames, en millisecondes
+struct FramePacingStats {
+    uint32_t sampleCount = 0;
+    float meanIntervalMs = 0.f;
+    float intervalVariance = 0.f;  // ms²
+    float intervalStdDevMs = 0.f;
+    float minIntervalMs = 0.f;
+    float maxIntervalMs = 0.f;
+};
+
+/**
+ * Limite la cadence de la boucle de rendu à une fréquence cible et mesure la régularité des présentations. L'attente
+ * dort jusqu'à SPIN_THRESHOLD_MS de l'échéance, le sleep de l'OS pouvant la dépasser d'une milliseconde ou plus, puis
+ * termine en attente active. Une frame trop en retard ne fait pas enchaîner les suivantes pour rattraper.
+ * Les intervalles sont mesurés sur le CPU quand vkQueuePresentKHR rend la main, pas au moment où l'image est
+ * affichée : ils suivent la cadence de la boucle, et l'affichage réel n'est visible qu'avec VK_GOOGLE_display_timing
+ * ou un outil externe.
+ */
+class LveFramePacer {
+   public:
+    static constexpr size_t STATS_WINDOW = 120;
+    static constexpr double SPIN_THRESHOLD_MS = 2.0;
+
+    // targetFps : 0 pour ne pas limiter
+    LveFramePacer(float targetFps = 0.f);
+
+    void setTargetFps(float fps);
+    float getTargetFps() const { return targetFps; }
+
+    // au début de chaque itération de la boucle, avant de lire les entrées
+    void waitForNextFrame();
+    // juste après le retour de vkQueuePresentKHR
+    void framePresented();
+
+    const FramePacingStats &getStats() const { return stats; }
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    void updateStats();
+
+    float targetFps = 0.f;
+    Clock::duration framePeriod{0};
+    Clock::time_point nextFrameTime;
+    bool nextFrameTimeValid = false;
+
+    Clock::time_point lastPresentTime;
+    bool presented = false;
+    std::array<float, STATS_WINDOW> intervals{};
+    size_t intervalCount = 0;
+    size_t nextInterval = 0;
+    FramePacingStats stats{};
+};
+}  // namespace lve
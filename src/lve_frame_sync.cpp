@@ -0,0 +1,144 @@
+#include "lve_frame_sync.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+
+namespace lve {
+
+LveFrameSync::LveFrameSync(LveDevice &device) : lveDevice{device} {
+    VkSemaphoreTypeCreateInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    timelineInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &timelineInfo;
+
+    if (vkCreateSemaphore(lveDevice.device(), &semaphoreInfo, nullptr, &timelineSemaphore) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create frame timeline semaphore!");
+    }
+}
+
+LveFrameSync::~LveFrameSync() { vkDestroySemaphore(lveDevice.device(), timelineSemaphore, nullptr); }
+
+void LveFrameSync::enqueue(LveFrameStage stage, VkCommandBuffer commandBuffer, VkSemaphore acquireSemaphore,
+                           VkSemaphore presentSemaphore) {
+    uint64_t signalValue = getStageValue(currentFrame, stage);
+    assert(signalValue > enqueuedValue && "frame stages must be enqueued in order");
+
+    // sur une même queue, un signal attend toutes les commandes soumises avant lui : atteindre une valeur garantit
+    // que les étapes précédentes sont terminées, une seule attente par étape suffit
+    uint64_t waitValue = 0;
+    VkPipelineStageFlags waitStageMask = 0;
+    switch (stage) {
+        case LveFrameStagePreProcessing:
+            // culling early : pyramide Hi-Z et visibilité écrites par le rendu de la frame précédente
+            if (currentFrame > 0) {
+                waitValue = getStageValue(currentFrame - 1, LveFrameStageRender);
+            }
+            waitStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            break;
+        case LveFrameStageRender:
+            // draw lists indirectes, textures de vagues et lumières produites par le pre-processing
+            waitValue = getStageValue(currentFrame, LveFrameStagePreProcessing);
+            waitStageMask = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            break;
+        case LveFrameStagePostProcessing:
+            // image de scène et profondeur lues par les effets, le blit de mise à l'échelle et la copie finale
+            waitValue = getStageValue(currentFrame, LveFrameStageRender);
+            waitStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+            break;
+        default:
+            throw std::runtime_error("unknown frame stage!");
+    }
+    // étape sautée : la dernière valeur ajoutée la couvre
+    waitValue = std::min(waitValue, enqueuedValue);
+
+    StageBatch batch{};
+    batch.commandBuffer = commandBuffer;
+    if (waitValue > 0) {
+        batch.waitSemaphores[batch.waitCount] = timelineSemaphore;
+        batch.waitValues[batch.waitCount] = waitValue;
+        batch.waitStages[batch.waitCount] = waitStageMask;
+        batch.waitCount++;
+    }
+    if (acquireSemaphore != VK_NULL_HANDLE) {
+        // seules la copie finale et la sortie storage écrivent l'image de la swapchain
+        batch.waitSemaphores[batch.waitCount] = acquireSemaphore;
+        batch.waitValues[batch.waitCount] = 0;
+        batch.waitStages[batch.waitCount] = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+        batch.waitCount++;
+    }
+
+    batch.signalSemaphores[batch.signalCount] = timelineSemaphore;
+    batch.signalValues[batch.signalCount] = signalValue;
+    batch.signalCount++;
+    if (presentSemaphore != VK_NULL_HANDLE) {
+        batch.signalSemaphores[batch.signalCount] = presentSemaphore;
+        batch.signalValues[batch.signalCount] = 0;
+        batch.signalCount++;
+    }
+
+    pendingBatches.push_back(batch);
+    enqueuedValue = signalValue;
+}
+
+void LveFrameSync::flush() {
+    if (pendingBatches.empty()) return;
+
+    std::vector<VkTimelineSemaphoreSubmitInfo> timelineInfos(pendingBatches.size());
+    std::vector<VkSubmitInfo> submitInfos(pendingBatches.size());
+    for (size_t i = 0; i < pendingBatches.size(); i++) {
+        const StageBatch &batch = pendingBatches[i];
+
+        timelineInfos[i].sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfos[i].waitSemaphoreValueCount = batch.waitCount;
+        timelineInfos[i].pWaitSemaphoreValues = batch.waitValues;
+        timelineInfos[i].signalSemaphoreValueCount = batch.signalCount;
+        timelineInfos[i].pSignalSemaphoreValues = batch.signalValues;
+
+        submitInfos[i].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfos[i].pNext = &timelineInfos[i];
+        submitInfos[i].waitSemaphoreCount = batch.waitCount;
+        submitInfos[i].pWaitSemaphores = batch.waitSemaphores;
+        submitInfos[i].pWaitDstStageMask = batch.waitStages;
+        submitInfos[i].commandBufferCount = 1;
+        submitInfos[i].pCommandBuffers = &batch.commandBuffer;
+        submitInfos[i].signalSemaphoreCount = batch.signalCount;
+        submitInfos[i].pSignalSemaphores = batch.signalSemaphores;
+    }
+
+    if (vkQueueSubmit(lveDevice.graphicsQueue(), static_cast<uint32_t>(submitInfos.size()), submitInfos.data(),
+                      VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("failed to submit frame command buffers!");
+    }
+    pendingBatches.clear();
+    submittedValue = enqueuedValue;
+}
+
+void LveFrameSync::waitForFrame(uint64_t frame) {
+    uint64_t value = std::min(getStageValue(frame, LveFrameStagePostProcessing), submittedValue);
+    if (value == 0) return;
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &timelineSemaphore;
+    waitInfo.pValues = &value;
+    if (vkWaitSemaphores(lveDevice.device(), &waitInfo, std::numeric_limits<uint64_t>::max()) != VK_SUCCESS) {
+        throw std::runtime_error("failed to wait for frame timeline semaphore!");
+    }
+}
+
+uint64_t LveFrameSync::getCompletedFrames() {
+    uint64_t value = 0;
+    if (vkGetSemaphoreCounterValue(lveDevice.device(), timelineSemaphore, &value) != VK_SUCCESS) {
+        throw std::runtime_error("failed to read frame timeline semaphore!");
+    }
+    return value / LveFrameStageCount;
+}
+}  // namespace lve
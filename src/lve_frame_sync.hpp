@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "lve_device.hpp"
+
+namespace lve {
+
+// étapes soumises dans cet ordre à chaque frame
+enum LveFrameStage {
+    LveFrameStagePreProcessing = 0,
+    LveFrameStageRender = 1,
+    LveFrameStagePostProcessing = 2,
+    LveFrameStageCount = 3,
+};
+
+/**
+ * Synchronisation des frames par un timeline semaphore, un seul compteur car toutes les étapes passent par la queue
+ * graphique. L'étape stage de la frame frame signale getStageValue(frame, stage) : chaque étape attend la valeur des
+ * étapes dont elle lit les résultats avec le masque des stages qui les lisent, et le CPU attend la dernière étape
+ * d'une frame avant de réutiliser ses ressources. La présentation ne sait pas attendre un timeline semaphore,
+ * l'acquisition et la présentation gardent les semaphores binaires de la swapchain.
+ * Les étapes d'une frame sont regroupées en un seul vkQueueSubmit par flush, un batch par étape : l'ordre entre elles
+ * vient des valeurs attendues, qui peuvent être signalées par un batch précédent du même appel.
+ */
+class LveFrameSync {
+   public:
+    LveFrameSync(LveDevice &device);
+    ~LveFrameSync();
+
+    LveFrameSync(const LveFrameSync &) = delete;
+    LveFrameSync &operator=(const LveFrameSync &) = delete;
+
+    static uint64_t getStageValue(uint64_t frame, LveFrameStage stage) {
+        return frame * LveFrameStageCount + stage + 1;
+    }
+
+    // frame dont les étapes vont être soumises
+    void beginFrame(uint64_t frame) { currentFrame = frame; }
+
+    // ajoute l'étape stage de la frame courante à la soumission de la frame. acquireSemaphore : semaphore binaire
+    // attendu avant d'écrire l'image de la swapchain, presentSemaphore : semaphore binaire signalé pour la
+    // présentation, VK_NULL_HANDLE sinon
+    void enqueue(LveFrameStage stage, VkCommandBuffer commandBuffer, VkSemaphore acquireSemaphore = VK_NULL_HANDLE,
+                 VkSemaphore presentSemaphore = VK_NULL_HANDLE);
+    // soumet les étapes ajoutées depuis le dernier appel en un seul vkQueueSubmit, avant la présentation
+    void flush();
+
+    // attend sur le CPU que toutes les étapes de la frame soient terminées
+    void waitForFrame(uint64_t frame);
+    // nombre de frames dont toutes les étapes sont terminées sur le GPU
+    uint64_t getCompletedFrames();
+
+   private:
+    // les valeurs des semaphores binaires sont ignorées
+    struct StageBatch {
+        VkCommandBuffer commandBuffer;
+        uint32_t waitCount = 0;
+        VkSemaphore waitSemaphores[2];
+        uint64_t waitValues[2];
+        VkPipelineStageFlags waitStages[2];
+        uint32_t signalCount = 0;
+        VkSemaphore signalSemaphores[2];
+        uint64_t signalValues[2];
+    };
+
+    LveDevice &lveDevice;
+
+    VkSemaphore timelineSemaphore = VK_NULL_HANDLE;
+    uint64_t currentFrame = 0;
+    std::vector<StageBatch> pendingBatches;
+    // plus grande valeur ajoutée, une attente au-delà ne serait jamais satisfaite
+    uint64_t enqueuedValue = 0;
+    // plus grande valeur soumise à la queue, seule limite des attentes du CPU
+    uint64_t submittedValue = 0;
+};
+}  // namespace lve
@@ -23,9 +23,13 @@ LveGPipeline::LveGPipeline(LveDevice &device, const std::string &vertFilepath, c
 }
 
 LveGPipeline::~LveGPipeline() {
-    vkDestroyShaderModule(lveDevice.device(), vertShaderModule, nullptr);
-    vkDestroyShaderModule(lveDevice.device(), fragShaderModule, nullptr);
-    vkDestroyPipeline(lveDevice.device(), graphicsPipeLine, nullptr);
+    // le pipeline peut encore être utilisé par les command buffers des frames en vol
+    lveDevice.retire([&device = lveDevice, vertModule = vertShaderModule, fragModule = fragShaderModule,
+                      pipeline = graphicsPipeLine]() {
+        vkDestroyShaderModule(device.device(), vertModule, nullptr);
+        vkDestroyShaderModule(device.device(), fragModule, nullptr);
+        vkDestroyPipeline(device.device(), pipeline, nullptr);
+    });
 }
 
 std::vector<char> LveGPipeline::readFile(const std::string &filepath) {
@@ -58,6 +62,13 @@ void LveGPipeline::creatGraphicsPipeline(const std::string &vertFilepath, const
     createShaderModule(vertCode, &vertShaderModule);
     createShaderModule(fragCode, &fragShaderModule);
 
+    VkSpecializationMapEntry vertexFormatEntry{0, 0, sizeof(uint32_t)};
+    VkSpecializationInfo vertexSpecializationInfo{};
+    vertexSpecializationInfo.mapEntryCount = 1;
+    vertexSpecializationInfo.pMapEntries = &vertexFormatEntry;
+    vertexSpecializationInfo.dataSize = sizeof(uint32_t);
+    vertexSpecializationInfo.pData = &configInfo.vertexFormat;
+
     VkPipelineShaderStageCreateInfo shaderStages[2];
 
     shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -66,7 +77,7 @@ void LveGPipeline::creatGraphicsPipeline(const std::string &vertFilepath, const
     shaderStages[0].pName = "main";
     shaderStages[0].flags = 0;
     shaderStages[0].pNext = nullptr;
-    shaderStages[0].pSpecializationInfo = nullptr;
+    shaderStages[0].pSpecializationInfo = &vertexSpecializationInfo;
 
     shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -25,6 +25,8 @@ struct PipelineConfigInfo {
     VkPipelineLayout pipelineLayout = nullptr;
     VkRenderPass renderPass = nullptr;
     uint32_t subpass = 0;
+    // constant_id 0 du vertex shader
+    uint32_t vertexFormat = 0;
 };
 
 class LveGPipeline {
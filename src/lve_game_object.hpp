@@ -7,6 +7,7 @@
 
 #include "lve_model.hpp"
 #include "lve_texture.hpp"
+#include "lve_texture_table.hpp"
 
 namespace lve {
 
@@ -51,9 +52,8 @@ class LveGameObject {
     // optionnel
     std::shared_ptr<LveModel> model{};
     std::shared_ptr<LveTexture> texture{};
-
-    std::unique_ptr<LveDescriptorPool> texturePool;
-    VkDescriptorSet textureDescriptorSet;
+    // index de texture dans la LveTextureTable, lu par simple_shader.frag
+    uint32_t textureIndex = LveTextureTable::NO_TEXTURE;
 
     std::unique_ptr<PoinLightComponent> pointLight = nullptr;
     std::unique_ptr<Water> water = nullptr;
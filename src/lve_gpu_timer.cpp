@@ -0,0 +1,88 @@
+#include "lve_gpu_timer.hpp"
+
+#include <array>
+#include <stdexcept>
+
+#include "lve_swap_chain.hpp"
+
+namespace lve {
+
+// début et fin des deux fenêtres mesurées
+static constexpr uint32_t QUERIES_PER_FRAME = 4;
+
+LveGpuTimer::LveGpuTimer(LveDevice &device) : lveDevice{device} {
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(lveDevice.getPhysicalDevice(), &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(lveDevice.getPhysicalDevice(), &queueFamilyCount, queueFamilies.data());
+
+    uint32_t validBits =
+        queueFamilies[lveDevice.findPhysicalQueueFamilies().graphicsAndComputeFamily].timestampValidBits;
+    supported = validBits > 0 && lveDevice.properties.limits.timestampPeriod > 0.f;
+    if (!supported) return;
+
+    timestampPeriod = lveDevice.properties.limits.timestampPeriod;
+    timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = LveSwapChain::getFramesInFlight() * QUERIES_PER_FRAME;
+    if (vkCreateQueryPool(lveDevice.device(), &queryPoolInfo, nullptr, &queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create timestamp query pool!");
+    }
+    pending.resize(LveSwapChain::getFramesInFlight(), false);
+}
+
+LveGpuTimer::~LveGpuTimer() {
+    if (queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(lveDevice.device(), queryPool, nullptr);
+    }
+}
+
+void LveGpuTimer::begin(VkCommandBuffer commandBuffer, int frameIndex) {
+    if (!supported) return;
+    vkCmdResetQueryPool(commandBuffer, queryPool, frameIndex * QUERIES_PER_FRAME, QUERIES_PER_FRAME);
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, frameIndex * QUERIES_PER_FRAME);
+}
+
+void LveGpuTimer::pause(VkCommandBuffer commandBuffer, int frameIndex) {
+    if (!supported) return;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool,
+                        frameIndex * QUERIES_PER_FRAME + 1);
+}
+
+void LveGpuTimer::resume(VkCommandBuffer commandBuffer, int frameIndex) {
+    if (!supported) return;
+    // pas TOP_OF_PIPE : seuls les stages compute et transfer attendent l'acquisition, le timestamp doit en faire
+    // partie pour être écrit une fois l'image disponible
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, queryPool,
+                        frameIndex * QUERIES_PER_FRAME + 2);
+}
+
+void LveGpuTimer::end(VkCommandBuffer commandBuffer, int frameIndex) {
+    if (!supported) return;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool,
+                        frameIndex * QUERIES_PER_FRAME + 3);
+    pending[frameIndex] = true;
+}
+
+bool LveGpuTimer::collect(int frameIndex, float &gpuTimeMs) {
+    if (!supported || !pending[frameIndex]) return false;
+
+    std::array<uint64_t, QUERIES_PER_FRAME> timestamps{};
+    VkResult result = vkGetQueryPoolResults(lveDevice.device(), queryPool, frameIndex * QUERIES_PER_FRAME,
+                                            QUERIES_PER_FRAME, sizeof(timestamps), timestamps.data(),
+                                            sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) return false;
+    pending[frameIndex] = false;
+
+    uint64_t ticks = 0;
+    for (uint32_t window = 0; window < QUERIES_PER_FRAME; window += 2) {
+        ticks += ((timestamps[window + 1] & timestampMask) - (timestamps[window] & timestampMask)) & timestampMask;
+    }
+    gpuTimeMs = static_cast<float>(ticks) * timestampPeriod * 1e-6f;
+    return true;
+}
+
+}  // namespace lve
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "lve_device.hpp"
+
+namespace lve {
+/**
+ * Mesure le temps GPU de chaque frame avec quatre timestamps par frame en vol, en deux fenêtres : du début du
+ * pre-processing à la fin du rendu, puis du début à la fin du post-processing. Le post-processing attend l'image de
+ * la swapchain : cette attente (vsync, file de présentation pleine) tombe entre les deux fenêtres et n'est pas
+ * comptée, seul le travail du GPU l'est.
+ */
+class LveGpuTimer {
+   public:
+    LveGpuTimer(LveDevice &device);
+    ~LveGpuTimer();
+
+    LveGpuTimer(const LveGpuTimer &) = delete;
+    LveGpuTimer &operator=(const LveGpuTimer &) = delete;
+
+    // hors render pass, au début du premier command buffer de la frame
+    void begin(VkCommandBuffer commandBuffer, int frameIndex);
+    // hors render pass, à la fin du dernier command buffer soumis avant l'attente de l'image de la swapchain
+    void pause(VkCommandBuffer commandBuffer, int frameIndex);
+    // au début du premier command buffer qui attend l'image de la swapchain
+    void resume(VkCommandBuffer commandBuffer, int frameIndex);
+    // à la fin du dernier command buffer de la frame
+    void end(VkCommandBuffer commandBuffer, int frameIndex);
+    // lit la mesure de la dernière frame qui a utilisé ce slot, elle doit être terminée
+    bool collect(int frameIndex, float &gpuTimeMs);
+
+    bool isSupported() const { return supported; }
+
+   private:
+    LveDevice &lveDevice;
+
+    bool supported = false;
+    float timestampPeriod = 1.f;  // nanosecondes par tick
+    uint64_t timestampMask = ~0ull;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    std::vector<bool> pending;
+};
+}  // namespace lve
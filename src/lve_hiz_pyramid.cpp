@@ -0,0 +1,290 @@
+#include "lve_hiz_pyramid.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "lve_utils.hpp"
+#include "systems/pipeline_builder.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+namespace lve {
+
+struct SimplePushConstantData {
+    glm::vec2 sourceSize;
+    glm::vec2 destinationSize;
+};
+
+static uint32_t previousPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result * 2 <= value) {
+        result *= 2;
+    }
+    return result;
+}
+
+LveHiZPyramid::LveHiZPyramid(LveDevice &device) : lveDevice{device} {
+    reduceSetLayout = LveDescriptorSetLayout::Builder(lveDevice)
+                          .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+                          .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+                          .build();
+
+    sampleSetLayout = LveDescriptorSetLayout::Builder(lveDevice)
+                          .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+                          .build();
+
+    PipelineCreateInfo pipelineCreateInfo{device,
+                                          LvePipeLineType::LvePipeLineTypeCompute,
+                                          {reduceSetLayout->getDescriptorSetLayout()},
+                                          {"shaders/hiz_reduce.comp.spv"},
+                                          sizeof(SimplePushConstantData),
+                                          LvePipelIneFunctionnality::None,
+                                          nullptr};
+
+    pipelineLayout = PipelineBuilder::BuildPipeLineLayout(pipelineCreateInfo);
+    lveCPipeline = PipelineBuilder::BuildComputesPipeline(pipelineCreateInfo, pipelineLayout);
+}
+
+LveHiZPyramid::~LveHiZPyramid() {
+    destroyImage();
+    vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr);
+}
+
+void LveHiZPyramid::resize(VkExtent2D depthExtent, const std::vector<VkImageView> &depthImageViews,
+                           const std::vector<VkSampler> &depthImageSamplers) {
+    destroyImage();
+
+    // puissance de deux inférieure : chaque texel du mip 0 couvre entre 1 et 2 texels de profondeur par axe
+    width = previousPowerOfTwo(depthExtent.width);
+    height = previousPowerOfTwo(depthExtent.height);
+    mipLevels = 1;
+    while ((std::max(width, height) >> mipLevels) > 0) {
+        mipLevels++;
+    }
+
+    createImage();
+    createDescriptorSets(depthImageViews, depthImageSamplers);
+    valid = false;
+}
+
+void LveHiZPyramid::createImage() {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = width;
+    imageInfo.extent.height = height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = VK_FORMAT_R32_SFLOAT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    lveDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, pyramidImage, pyramidImageMemory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = pyramidImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R32_SFLOAT;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1};
+    if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &pyramidView) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create depth pyramid image view!");
+    }
+
+    mipViews.resize(mipLevels);
+    for (uint32_t i = 0; i < mipLevels; i++) {
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1};
+        if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &mipViews[i]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create depth pyramid mip view!");
+        }
+    }
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.compareOp = VK_COMPARE_OP_NEVER;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = static_cast<float>(mipLevels);
+    samplerInfo.anisotropyEnable = VK_FALSE;
+    samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+    if (vkCreateSampler(lveDevice.device(), &samplerInfo, nullptr, &pyramidSampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create depth pyramid sampler!");
+    }
+
+    // la pyramide reste en GENERAL : écrite en storage image et lue par sampler
+    VkCommandBuffer commandBuffer = lveDevice.beginSingleTimeCommands();
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = pyramidImage;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+    lveDevice.endSingleTimeCommands(commandBuffer);
+}
+
+void LveHiZPyramid::createDescriptorSets(const std::vector<VkImageView> &depthImageViews,
+                                         const std::vector<VkSampler> &depthImageSamplers) {
+    uint32_t setCount = static_cast<uint32_t>(depthImageViews.size()) + mipLevels;
+    pyramidPool = LveDescriptorPool::Builder(lveDevice)
+                      .setMaxSets(setCount)
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, setCount)
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, setCount)
+                      .build();
+
+    VkDescriptorImageInfo mip0Info{};
+    mip0Info.imageView = mipViews[0];
+    mip0Info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    depthReduceDescriptorSets.resize(depthImageViews.size());
+    for (size_t i = 0; i < depthImageViews.size(); i++) {
+        VkDescriptorImageInfo depthInfo{};
+        depthInfo.sampler = depthImageSamplers[i];
+        depthInfo.imageView = depthImageViews[i];
+        depthInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        LveDescriptorWriter(*reduceSetLayout, *pyramidPool)
+            .writeImage(0, &depthInfo)
+            .writeImage(1, &mip0Info)
+            .build(depthReduceDescriptorSets[i]);
+    }
+
+    mipReduceDescriptorSets.resize(mipLevels - 1);
+    for (uint32_t i = 1; i < mipLevels; i++) {
+        VkDescriptorImageInfo sourceInfo{};
+        sourceInfo.sampler = pyramidSampler;
+        sourceInfo.imageView = mipViews[i - 1];
+        sourceInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorImageInfo destinationInfo{};
+        destinationInfo.imageView = mipViews[i];
+        destinationInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        LveDescriptorWriter(*reduceSetLayout, *pyramidPool)
+            .writeImage(0, &sourceInfo)
+            .writeImage(1, &destinationInfo)
+            .build(mipReduceDescriptorSets[i - 1]);
+    }
+
+    VkDescriptorImageInfo pyramidInfo{};
+    pyramidInfo.sampler = pyramidSampler;
+    pyramidInfo.imageView = pyramidView;
+    pyramidInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    LveDescriptorWriter(*sampleSetLayout, *pyramidPool).writeImage(0, &pyramidInfo).build(sampleDescriptorSet);
+}
+
+void LveHiZPyramid::destroyImage() {
+    if (pyramidImage == VK_NULL_HANDLE) return;
+
+    // les frames en vol peuvent encore lire l'ancienne pyramide
+    std::shared_ptr<LveDescriptorPool> pool = std::move(pyramidPool);
+    lveDevice.retire([&device = lveDevice, pool, sampler = pyramidSampler, views = mipViews, view = pyramidView,
+                      image = pyramidImage, memory = pyramidImageMemory]() {
+        vkDestroySampler(device.device(), sampler, nullptr);
+        for (auto mipView : views) {
+            vkDestroyImageView(device.device(), mipView, nullptr);
+        }
+        vkDestroyImageView(device.device(), view, nullptr);
+        vkDestroyImage(device.device(), image, nullptr);
+        vkFreeMemory(device.device(), memory, nullptr);
+    });
+    mipViews.clear();
+    pyramidImage = VK_NULL_HANDLE;
+}
+
+void LveHiZPyramid::build(VkCommandBuffer commandBuffer, VkImage depthImage, uint32_t imageIndex,
+                          VkExtent2D renderExtent) {
+    std::array<VkImageMemoryBarrier, 2> barriers{};
+    barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barriers[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[0].image = depthImage;
+    barriers[0].subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1};
+
+    // la pyramide de la frame précédente a pu être lue par le culling
+    barriers[1].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barriers[1].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barriers[1].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[1].image = pyramidImage;
+    barriers[1].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1};
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr,
+                         static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    lveCPipeline->bind(commandBuffer);
+
+    glm::vec2 sourceSize{renderExtent.width, renderExtent.height};
+    for (uint32_t level = 0; level < mipLevels; level++) {
+        glm::vec2 destinationSize{std::max(width >> level, 1u), std::max(height >> level, 1u)};
+        VkDescriptorSet descriptorSet =
+            level == 0 ? depthReduceDescriptorSets[imageIndex] : mipReduceDescriptorSets[level - 1];
+
+        SimplePushConstantData push{};
+        push.sourceSize = sourceSize;
+        push.destinationSize = destinationSize;
+        vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                           sizeof(SimplePushConstantData), &push);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet,
+                                0, nullptr);
+        vkCmdDispatch(commandBuffer, static_cast<uint32_t>(destinationSize.x) / 32 + 1,
+                      static_cast<uint32_t>(destinationSize.y) / 32 + 1, 1);
+
+        VkImageMemoryBarrier mipBarrier{};
+        mipBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        mipBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        mipBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        mipBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        mipBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        mipBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        mipBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        mipBarrier.image = pyramidImage;
+        mipBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1};
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &mipBarrier);
+
+        sourceSize = destinationSize;
+    }
+
+    VkImageMemoryBarrier depthBarrier = barriers[0];
+    depthBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    depthBarrier.dstAccessMask =
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthBarrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &depthBarrier);
+
+    valid = true;
+}
+
+}  // namespace lve
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lve_c_pipeline.hpp"
+#include "lve_descriptor.hpp"
+#include "lve_device.hpp"
+
+namespace lve {
+/**
+ * Pyramide de profondeur hiérarchique (Hi-Z) : chaque mip contient la profondeur maximale (la plus lointaine) de
+ * son empreinte dans le depth buffer de la swapchain. Sert au test d'occlusion du CullingSystem.
+ */
+class LveHiZPyramid {
+   public:
+    LveHiZPyramid(LveDevice &device);
+    ~LveHiZPyramid();
+
+    LveHiZPyramid(const LveHiZPyramid &) = delete;
+    LveHiZPyramid &operator=(const LveHiZPyramid &) = delete;
+
+    // (re)crée la pyramide pour un nouveau depth buffer, l'ancienne est libérée par LveDevice::retire
+    void resize(VkExtent2D depthExtent, const std::vector<VkImageView> &depthImageViews,
+                const std::vector<VkSampler> &depthImageSamplers);
+
+    // le depth buffer doit être en DEPTH_STENCIL_ATTACHMENT_OPTIMAL, il y est remis à la fin. Seule la zone
+    // renderExtent (en haut à gauche) est réduite, la pyramide couvre donc toujours exactement le viewport
+    void build(VkCommandBuffer commandBuffer, VkImage depthImage, uint32_t imageIndex, VkExtent2D renderExtent);
+
+    VkDescriptorSetLayout getDescriptorSetLayout() const { return sampleSetLayout->getDescriptorSetLayout(); }
+    VkDescriptorSet getDescriptorSet() const { return sampleDescriptorSet; }
+    VkExtent2D getExtent() const { return {width, height}; }
+    uint32_t getMipLevels() const { return mipLevels; }
+    bool isValid() const { return valid; }
+
+   private:
+    void createImage();
+    void createDescriptorSets(const std::vector<VkImageView> &depthImageViews,
+                              const std::vector<VkSampler> &depthImageSamplers);
+    void destroyImage();
+
+    LveDevice &lveDevice;
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 0;
+    bool valid = false;
+
+    VkImage pyramidImage = VK_NULL_HANDLE;
+    VkDeviceMemory pyramidImageMemory = VK_NULL_HANDLE;
+    VkImageView pyramidView = VK_NULL_HANDLE;
+    std::vector<VkImageView> mipViews;
+    VkSampler pyramidSampler = VK_NULL_HANDLE;
+
+    std::unique_ptr<LveDescriptorPool> pyramidPool;
+    std::unique_ptr<LveDescriptorSetLayout> reduceSetLayout;
+    std::unique_ptr<LveDescriptorSetLayout> sampleSetLayout;
+    std::vector<VkDescriptorSet> depthReduceDescriptorSets;  // un par image de la swapchain
+    std::vector<VkDescriptorSet> mipReduceDescriptorSets;    // mip n-1 -> mip n
+    VkDescriptorSet sampleDescriptorSet;
+
+    std::unique_ptr<LveCPipeline> lveCPipeline;
+    VkPipelineLayout pipelineLayout;
+};
+}  // namespace lve
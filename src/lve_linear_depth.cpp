@@ -0,0 +1,255 @@
+#include "lve_linear_depth.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "lve_utils.hpp"
+#include "systems/pipeline_builder.hpp"
+
+namespace lve {
+
+struct SimplePushConstantData {
+    glm::vec2 sourceSize;
+    glm::vec2 destinationSize;
+    float depthScale;
+    float projection22;
+    float projection32;
+    int level;
+};
+
+LveLinearDepth::LveLinearDepth(LveDevice &device, VkExtent2D extent, const std::vector<VkImageView> &depthImageViews,
+                               const std::vector<VkSampler> &depthImageSamplers)
+    : lveDevice{device} {
+    reduceSetLayout = LveDescriptorSetLayout::Builder(lveDevice)
+                          .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+                          .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+                          .build();
+
+    PipelineCreateInfo pipelineCreateInfo{device,
+                                          LvePipeLineType::LvePipeLineTypeCompute,
+                                          {reduceSetLayout->getDescriptorSetLayout()},
+                                          {"shaders/linear_depth.comp.spv"},
+                                          sizeof(SimplePushConstantData),
+                                          LvePipelIneFunctionnality::None,
+                                          nullptr};
+
+    pipelineLayout = PipelineBuilder::BuildPipeLineLayout(pipelineCreateInfo);
+    lveCPipeline = PipelineBuilder::BuildComputesPipeline(pipelineCreateInfo, pipelineLayout);
+
+    resize(extent, depthImageViews, depthImageSamplers);
+}
+
+LveLinearDepth::~LveLinearDepth() {
+    destroyImage();
+    vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr);
+}
+
+void LveLinearDepth::resize(VkExtent2D extent, const std::vector<VkImageView> &depthImageViews,
+                            const std::vector<VkSampler> &depthImageSamplers) {
+    destroyImage();
+
+    width = extent.width;
+    height = extent.height;
+    mipLevels = 1;
+    while ((std::max(width, height) >> mipLevels) > 0) {
+        mipLevels++;
+    }
+
+    createImage();
+    createDescriptorSets(depthImageViews, depthImageSamplers);
+}
+
+void LveLinearDepth::destroyImage() {
+    if (depthImage == VK_NULL_HANDLE) return;
+
+    // les frames en vol peuvent encore lire l'ancienne image
+    std::shared_ptr<LveDescriptorPool> pool = std::move(linearDepthPool);
+    lveDevice.retire([&device = lveDevice, pool, sampler = depthSampler, views = mipViews, view = depthView,
+                      image = depthImage, memory = depthImageMemory]() {
+        vkDestroySampler(device.device(), sampler, nullptr);
+        for (auto mipView : views) {
+            vkDestroyImageView(device.device(), mipView, nullptr);
+        }
+        vkDestroyImageView(device.device(), view, nullptr);
+        vkDestroyImage(device.device(), image, nullptr);
+        vkFreeMemory(device.device(), memory, nullptr);
+    });
+    mipViews.clear();
+    depthImage = VK_NULL_HANDLE;
+}
+
+void LveLinearDepth::createImage() {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = width;
+    imageInfo.extent.height = height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = VK_FORMAT_R32G32_SFLOAT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    lveDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage, depthImageMemory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = depthImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R32G32_SFLOAT;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1};
+    if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &depthView) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create linear depth image view!");
+    }
+
+    mipViews.resize(mipLevels);
+    for (uint32_t i = 0; i < mipLevels; i++) {
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1};
+        if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &mipViews[i]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create linear depth mip view!");
+        }
+    }
+
+    // NEAREST : un min/max interpolé ne serait plus conservatif
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.compareOp = VK_COMPARE_OP_NEVER;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = static_cast<float>(mipLevels);
+    samplerInfo.anisotropyEnable = VK_FALSE;
+    samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+    if (vkCreateSampler(lveDevice.device(), &samplerInfo, nullptr, &depthSampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create linear depth sampler!");
+    }
+
+    // l'image reste en GENERAL : écrite en storage image et lue par sampler
+    VkCommandBuffer commandBuffer = lveDevice.beginSingleTimeCommands();
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = depthImage;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+    lveDevice.endSingleTimeCommands(commandBuffer);
+}
+
+void LveLinearDepth::createDescriptorSets(const std::vector<VkImageView> &depthImageViews,
+                                          const std::vector<VkSampler> &depthImageSamplers) {
+    uint32_t setCount = static_cast<uint32_t>(depthImageViews.size()) + mipLevels;
+    linearDepthPool = LveDescriptorPool::Builder(lveDevice)
+                          .setMaxSets(setCount)
+                          .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, setCount)
+                          .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, setCount)
+                          .build();
+
+    VkDescriptorImageInfo mip0Info{};
+    mip0Info.imageView = mipViews[0];
+    mip0Info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    depthReduceDescriptorSets.resize(depthImageViews.size());
+    for (size_t i = 0; i < depthImageViews.size(); i++) {
+        VkDescriptorImageInfo depthInfo{};
+        depthInfo.sampler = depthImageSamplers[i];
+        depthInfo.imageView = depthImageViews[i];
+        depthInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        LveDescriptorWriter(*reduceSetLayout, *linearDepthPool)
+            .writeImage(0, &depthInfo)
+            .writeImage(1, &mip0Info)
+            .build(depthReduceDescriptorSets[i]);
+    }
+
+    mipReduceDescriptorSets.resize(mipLevels - 1);
+    for (uint32_t i = 1; i < mipLevels; i++) {
+        VkDescriptorImageInfo sourceInfo{};
+        sourceInfo.sampler = depthSampler;
+        sourceInfo.imageView = mipViews[i - 1];
+        sourceInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorImageInfo destinationInfo{};
+        destinationInfo.imageView = mipViews[i];
+        destinationInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        LveDescriptorWriter(*reduceSetLayout, *linearDepthPool)
+            .writeImage(0, &sourceInfo)
+            .writeImage(1, &destinationInfo)
+            .build(mipReduceDescriptorSets[i - 1]);
+    }
+
+    VkDescriptorImageInfo linearDepthInfo{};
+    linearDepthInfo.sampler = depthSampler;
+    linearDepthInfo.imageView = depthView;
+    linearDepthInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    LveDescriptorWriter(*LveDescriptorSetLayout::linearDepthSetLayout, *linearDepthPool)
+        .writeImage(0, &linearDepthInfo)
+        .build(sampleDescriptorSet);
+}
+
+void LveLinearDepth::build(VkCommandBuffer commandBuffer, uint32_t imageIndex, const glm::mat4 &projection,
+                           float depthScale) {
+    // les effets de la frame précédente ont pu lire la pyramide
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = depthImage;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         0, nullptr, 0, nullptr, 1, &barrier);
+
+    lveCPipeline->bind(commandBuffer);
+
+    glm::vec2 sourceSize{width, height};
+    for (uint32_t level = 0; level < mipLevels; level++) {
+        glm::vec2 destinationSize{std::max(width >> level, 1u), std::max(height >> level, 1u)};
+        VkDescriptorSet descriptorSet =
+            level == 0 ? depthReduceDescriptorSets[imageIndex] : mipReduceDescriptorSets[level - 1];
+
+        SimplePushConstantData push{};
+        push.sourceSize = sourceSize;
+        push.destinationSize = destinationSize;
+        push.depthScale = depthScale;
+        push.projection22 = projection[2][2];
+        push.projection32 = projection[3][2];
+        push.level = static_cast<int>(level);
+        vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                           sizeof(SimplePushConstantData), &push);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet,
+                                0, nullptr);
+        vkCmdDispatch(commandBuffer, (static_cast<uint32_t>(destinationSize.x) + 15) / 16,
+                      (static_cast<uint32_t>(destinationSize.y) + 15) / 16, 1);
+
+        // le dernier mip est aussi rendu visible, les effets lisent toute la chaîne
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1};
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        sourceSize = destinationSize;
+    }
+}
+
+}  // namespace lve
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "lve_c_pipeline.hpp"
+#include "lve_descriptor.hpp"
+#include "lve_device.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+namespace lve {
+/**
+ * Profondeur linéaire (espace vue) de la frame à la taille des images de post-processing, reconstruite avec la
+ * projection de la caméra. r : profondeur minimale, g : profondeur maximale de l'empreinte du texel, chaque mip
+ * réduisant le précédent. Les effets la lisent par LveDescriptorSetLayout::linearDepthSetLayout.
+ */
+class LveLinearDepth {
+   public:
+    // profondeur écrite pour le ciel (depth buffer à 1), doit correspondre à SKY_DEPTH dans linear_depth.comp
+    static constexpr float SKY_DEPTH = 1e6f;
+
+    LveLinearDepth(LveDevice &device, VkExtent2D extent, const std::vector<VkImageView> &depthImageViews,
+                   const std::vector<VkSampler> &depthImageSamplers);
+    ~LveLinearDepth();
+
+    LveLinearDepth(const LveLinearDepth &) = delete;
+    LveLinearDepth &operator=(const LveLinearDepth &) = delete;
+
+    // nouvelle taille des images de post-processing, l'ancienne image est libérée par LveDevice::retire
+    void resize(VkExtent2D extent, const std::vector<VkImageView> &depthImageViews,
+                const std::vector<VkSampler> &depthImageSamplers);
+
+    // le depth buffer doit être en SHADER_READ_ONLY_OPTIMAL. depthScale : fraction du depth buffer couverte par la
+    // scène, agrandie à toute l'image comme la couleur
+    void build(VkCommandBuffer commandBuffer, uint32_t imageIndex, const glm::mat4 &projection, float depthScale);
+
+    VkDescriptorSet getDescriptorSet() const { return sampleDescriptorSet; }
+    uint32_t getMipLevels() const { return mipLevels; }
+
+   private:
+    void createImage();
+    void destroyImage();
+    void createDescriptorSets(const std::vector<VkImageView> &depthImageViews,
+                              const std::vector<VkSampler> &depthImageSamplers);
+
+    LveDevice &lveDevice;
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipLevels = 1;
+
+    VkImage depthImage = VK_NULL_HANDLE;
+    VkDeviceMemory depthImageMemory = VK_NULL_HANDLE;
+    VkImageView depthView = VK_NULL_HANDLE;
+    std::vector<VkImageView> mipViews;
+    VkSampler depthSampler = VK_NULL_HANDLE;
+
+    std::unique_ptr<LveDescriptorPool> linearDepthPool;
+    std::unique_ptr<LveDescriptorSetLayout> reduceSetLayout;
+    std::vector<VkDescriptorSet> depthReduceDescriptorSets;  // un par image de la swapchain
+    std::vector<VkDescriptorSet> mipReduceDescriptorSets;    // mip n-1 -> mip n
+    VkDescriptorSet sampleDescriptorSet;
+
+    std::unique_ptr<LveCPipeline> lveCPipeline;
+    VkPipelineLayout pipelineLayout;
+};
+}  // namespace lve
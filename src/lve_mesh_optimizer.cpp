@@ -0,0 +1,415 @@
+#include "lve_mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+namespace lve {
+
+// somme des carrés des distances d'un point à un ensemble de plans, matrice 4x4 symétrique
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0, a11 = 0, a12 = 0, a13 = 0, a22 = 0, a23 = 0, a33 = 0;
+
+    void addPlane(double a, double b, double c, double d) {
+        a00 += a * a, a01 += a * b, a02 += a * c, a03 += a * d;
+        a11 += b * b, a12 += b * c, a13 += b * d;
+        a22 += c * c, a23 += c * d;
+        a33 += d * d;
+    }
+
+    void add(const Quadric &other) {
+        a00 += other.a00, a01 += other.a01, a02 += other.a02, a03 += other.a03;
+        a11 += other.a11, a12 += other.a12, a13 += other.a13;
+        a22 += other.a22, a23 += other.a23;
+        a33 += other.a33;
+    }
+
+    double evaluate(const glm::vec3 &p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double value = a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x + a11 * y * y +
+                       2 * a12 * y * z + 2 * a13 * y + a22 * z * z + 2 * a23 * z + a33;
+        return std::max(value, 0.0);
+    }
+};
+
+struct EdgeCollapse {
+    uint32_t from;
+    uint32_t to;
+    double cost;
+};
+
+MeshOptimizationStats LveMeshOptimizer::optimize(std::vector<LveModel::Vertex> &vertices,
+                                                 std::vector<uint32_t> &indices) {
+    assert(indices.size() % 3 == 0 && "Mesh optimisation expects a triangle list");
+    uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+
+    MeshOptimizationStats stats{};
+    stats.acmrBefore = computeACMR(indices, vertexCount);
+
+    std::vector<uint32_t> clusters;
+    std::vector<uint32_t> cacheOrder = optimizeVertexCache(indices, vertexCount, clusters);
+    std::vector<uint32_t> overdrawOrder = optimizeOverdraw(cacheOrder, clusters, vertices);
+    if (computeACMR(overdrawOrder, vertexCount) <= computeACMR(cacheOrder, vertexCount) * OVERDRAW_ACMR_THRESHOLD) {
+        indices.swap(overdrawOrder);
+    } else {
+        indices.swap(cacheOrder);
+    }
+
+    optimizeVertexFetch(vertices, indices);
+    stats.acmrAfter = computeACMR(indices, static_cast<uint32_t>(vertices.size()));
+    return stats;
+}
+
+float LveMeshOptimizer::computeACMR(const std::vector<uint32_t> &indices, uint32_t vertexCount, uint32_t cacheSize) {
+    if (indices.empty()) {
+        return 0.f;
+    }
+
+    // cache FIFO : un vertex est dans le cache si moins de cacheSize vertex y sont entrés depuis lui
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+    for (uint32_t index : indices) {
+        if (time - cacheTime[index] > cacheSize) {
+            cacheTime[index] = time++;
+            misses++;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+std::vector<uint32_t> LveMeshOptimizer::optimizeVertexCache(const std::vector<uint32_t> &indices,
+                                                            uint32_t vertexCount, std::vector<uint32_t> &clusters,
+                                                            uint32_t cacheSize) {
+    uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    clusters.clear();
+
+    // adjacence vertex -> triangles en CSR
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (uint32_t index : indices) {
+        liveTriangles[index]++;
+    }
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (uint32_t triangle = 0; triangle < triangleCount; triangle++) {
+        for (uint32_t corner = 0; corner < 3; corner++) {
+            adjacency[fill[indices[triangle * 3 + corner]]++] = triangle;
+        }
+    }
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnds;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+
+    uint32_t time = cacheSize + 1;
+    uint32_t cursor = 0;
+    int64_t fanning = vertexCount > 0 ? 0 : -1;
+    bool newCluster = true;
+
+    while (fanning >= 0) {
+        candidates.clear();
+        uint32_t v0 = static_cast<uint32_t>(fanning);
+        for (uint32_t a = adjacencyOffsets[v0]; a < adjacencyOffsets[v0 + 1]; a++) {
+            uint32_t triangle = adjacency[a];
+            if (emitted[triangle]) continue;
+            if (newCluster) {
+                clusters.push_back(static_cast<uint32_t>(result.size() / 3));
+                newCluster = false;
+            }
+
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                uint32_t v = indices[triangle * 3 + corner];
+                result.push_back(v);
+                deadEnds.push_back(v);
+                candidates.push_back(v);
+                liveTriangles[v]--;
+                if (time - cacheTime[v] > cacheSize) {
+                    cacheTime[v] = time++;
+                }
+            }
+            emitted[triangle] = true;
+        }
+
+        // prochain éventail : le candidat qui restera dans le cache le plus longtemps
+        fanning = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t v : candidates) {
+            if (liveTriangles[v] == 0) continue;
+            int64_t priority = 0;
+            if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize) {
+                priority = time - cacheTime[v];
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                fanning = v;
+            }
+        }
+
+        // impasse : on reprend un vertex récent encore vivant, sinon le suivant dans l'ordre des indices
+        if (fanning < 0) {
+            newCluster = true;
+            while (!deadEnds.empty()) {
+                uint32_t v = deadEnds.back();
+                deadEnds.pop_back();
+                if (liveTriangles[v] > 0) {
+                    fanning = v;
+                    break;
+                }
+            }
+            while (fanning < 0 && cursor < vertexCount) {
+                if (liveTriangles[cursor] > 0) {
+                    fanning = cursor;
+                }
+                cursor++;
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<uint32_t> LveMeshOptimizer::optimizeOverdraw(const std::vector<uint32_t> &indices,
+                                                         const std::vector<uint32_t> &clusters,
+                                                         const std::vector<LveModel::Vertex> &vertices) {
+    uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (clusters.size() < 2) {
+        return indices;
+    }
+
+    // centre et normale de chaque groupe, pondérés par l'aire des triangles
+    std::vector<glm::vec3> clusterCenters(clusters.size(), glm::vec3(0.f));
+    std::vector<glm::vec3> clusterNormals(clusters.size(), glm::vec3(0.f));
+    std::vector<float> clusterAreas(clusters.size(), 0.f);
+    glm::vec3 meshCenter{0.f};
+    float meshArea = 0.f;
+    for (uint32_t cluster = 0; cluster < clusters.size(); cluster++) {
+        uint32_t end = cluster + 1 < clusters.size() ? clusters[cluster + 1] : triangleCount;
+        for (uint32_t triangle = clusters[cluster]; triangle < end; triangle++) {
+            const glm::vec3 &p0 = vertices[indices[triangle * 3 + 0]].position;
+            const glm::vec3 &p1 = vertices[indices[triangle * 3 + 1]].position;
+            const glm::vec3 &p2 = vertices[indices[triangle * 3 + 2]].position;
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(normal);
+
+            clusterCenters[cluster] += (p0 + p1 + p2) * (area / 3.f);
+            clusterNormals[cluster] += normal;
+            clusterAreas[cluster] += area;
+        }
+        meshCenter += clusterCenters[cluster];
+        meshArea += clusterAreas[cluster];
+    }
+    if (meshArea > 0.f) {
+        meshCenter /= meshArea;
+    }
+
+    std::vector<float> sortKeys(clusters.size(), 0.f);
+    for (uint32_t cluster = 0; cluster < clusters.size(); cluster++) {
+        if (clusterAreas[cluster] == 0.f) continue;
+        glm::vec3 center = clusterCenters[cluster] / clusterAreas[cluster];
+        float normalLength = glm::length(clusterNormals[cluster]);
+        if (normalLength == 0.f) continue;
+        sortKeys[cluster] = glm::dot(center - meshCenter, clusterNormals[cluster] / normalLength);
+    }
+
+    std::vector<uint32_t> order(clusters.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&sortKeys](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (uint32_t cluster : order) {
+        uint32_t end = cluster + 1 < clusters.size() ? clusters[cluster + 1] : triangleCount;
+        result.insert(result.end(), indices.begin() + clusters[cluster] * 3, indices.begin() + end * 3);
+    }
+    return result;
+}
+
+void LveMeshOptimizer::optimizeVertexFetch(std::vector<LveModel::Vertex> &vertices, std::vector<uint32_t> &indices) {
+    constexpr uint32_t UNUSED = ~0u;
+    std::vector<uint32_t> remap(vertices.size(), UNUSED);
+    std::vector<LveModel::Vertex> reordered;
+    reordered.reserve(vertices.size());
+
+    for (uint32_t &index : indices) {
+        if (remap[index] == UNUSED) {
+            remap[index] = static_cast<uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices.swap(reordered);
+}
+
+std::vector<uint32_t> LveMeshOptimizer::simplify(const std::vector<LveModel::Vertex> &vertices,
+                                                 const std::vector<uint32_t> &indices, size_t targetIndexCount,
+                                                 float &error) {
+    uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+    std::vector<uint32_t> result = indices;
+    error = 0.f;
+
+    // coutures : les vertex qui partagent leur position avec un autre (uv ou normale différentes) restent en place
+    std::vector<bool> seams(vertexCount, false);
+    std::vector<uint32_t> byPosition(vertexCount);
+    std::iota(byPosition.begin(), byPosition.end(), 0);
+    auto positionLess = [&vertices](uint32_t a, uint32_t b) {
+        const glm::vec3 &pa = vertices[a].position;
+        const glm::vec3 &pb = vertices[b].position;
+        if (pa.x != pb.x) return pa.x < pb.x;
+        if (pa.y != pb.y) return pa.y < pb.y;
+        return pa.z < pb.z;
+    };
+    std::sort(byPosition.begin(), byPosition.end(), positionLess);
+    for (uint32_t i = 1; i < vertexCount; i++) {
+        if (!positionLess(byPosition[i - 1], byPosition[i])) {
+            seams[byPosition[i - 1]] = true;
+            seams[byPosition[i]] = true;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i < result.size(); i += 3) {
+        const glm::vec3 &p0 = vertices[result[i + 0]].position;
+        const glm::vec3 &p1 = vertices[result[i + 1]].position;
+        const glm::vec3 &p2 = vertices[result[i + 2]].position;
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float length = glm::length(normal);
+        if (length == 0.f) continue;
+        normal = normal / length;
+        double d = -glm::dot(normal, p0);
+        for (uint32_t corner = 0; corner < 3; corner++) {
+            quadrics[result[i + corner]].addPlane(normal.x, normal.y, normal.z, d);
+        }
+    }
+
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> locked(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<EdgeCollapse> collapses;
+    std::unordered_map<uint64_t, uint32_t> edgeCounts;
+    double maxCost = 0.0;
+
+    // chaque passe effondre des arêtes indépendantes (voisinages disjoints) par coût croissant
+    while (result.size() > targetIndexCount) {
+        size_t triangleCount = result.size() / 3;
+
+        // les bords (arête d'un seul triangle) et les arêtes non manifold sont verrouillés
+        locked.assign(seams.begin(), seams.end());
+        edgeCounts.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                uint32_t a = result[i + corner];
+                uint32_t b = result[i + (corner + 1) % 3];
+                edgeCounts[(static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b)]++;
+            }
+        }
+        for (const auto &kv : edgeCounts) {
+            if (kv.second != 2) {
+                locked[kv.first >> 32] = true;
+                locked[kv.first & 0xFFFFFFFF] = true;
+            }
+        }
+
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (uint32_t index : result) {
+            adjacencyOffsets[index + 1]++;
+        }
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        }
+        adjacency.resize(result.size());
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t triangle = 0; triangle < triangleCount; triangle++) {
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                adjacency[fill[result[triangle * 3 + corner]]++] = triangle;
+            }
+        }
+
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                uint32_t a = result[i + corner];
+                uint32_t b = result[i + (corner + 1) % 3];
+                Quadric quadric = quadrics[a];
+                quadric.add(quadrics[b]);
+                if (!locked[a]) collapses.push_back({a, b, quadric.evaluate(vertices[b].position)});
+                if (!locked[b]) collapses.push_back({b, a, quadric.evaluate(vertices[a].position)});
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const EdgeCollapse &a, const EdgeCollapse &b) { return a.cost < b.cost; });
+
+        std::iota(remap.begin(), remap.end(), 0);
+        std::fill(touched.begin(), touched.end(), false);
+        size_t trianglesToRemove = (result.size() - targetIndexCount + 2) / 3;
+        size_t trianglesRemoved = 0;
+
+        for (const EdgeCollapse &collapse : collapses) {
+            if (trianglesRemoved >= trianglesToRemove) break;
+            if (touched[collapse.from] || touched[collapse.to]) continue;
+
+            // refuse l'effondrement s'il retourne un des triangles qui restent autour de from
+            const glm::vec3 &target = vertices[collapse.to].position;
+            bool flips = false;
+            uint32_t removed = 0;
+            for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++) {
+                const uint32_t *triangle = &result[adjacency[a] * 3];
+                if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+                    removed++;
+                    continue;
+                }
+                glm::vec3 before[3];
+                glm::vec3 after[3];
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    before[corner] = vertices[triangle[corner]].position;
+                    after[corner] = triangle[corner] == collapse.from ? target : before[corner];
+                }
+                glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+                glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+                if (glm::dot(normalBefore, normalAfter) <= 0.f) {
+                    flips = true;
+                    break;
+                }
+            }
+            if (flips) continue;
+
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            maxCost = std::max(maxCost, collapse.cost);
+            trianglesRemoved += removed;
+            for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++) {
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    touched[result[adjacency[a] * 3 + corner]] = true;
+                }
+            }
+        }
+        if (trianglesRemoved == 0) break;
+
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            uint32_t a = remap[result[i + 0]];
+            uint32_t b = remap[result[i + 1]];
+            uint32_t c = remap[result[i + 2]];
+            if (a == b || b == c || a == c) continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    error = static_cast<float>(std::sqrt(maxCost));
+    return result;
+}
+
+}  // namespace lve
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "lve_model.hpp"
+
+namespace lve {
+
+struct MeshOptimizationStats {
+    float acmrBefore = 0.f;  // vertex transformés par triangle, cache FIFO de LveMeshOptimizer::CACHE_SIZE
+    float acmrAfter = 0.f;
+};
+
+/**
+ * Réordonne un mesh indexé après chargement : triangles pour le cache post-transform (Tipsify, Sander et al. 2007),
+ * puis groupes de triangles pour l'overdraw, puis vertex dans l'ordre de première utilisation pour le fetch.
+ * Génère aussi des versions simplifiées (quadriques de Garland & Heckbert) qui partagent les vertex du modèle.
+ */
+class LveMeshOptimizer {
+   public:
+    static constexpr uint32_t CACHE_SIZE = 16;
+    // l'ordre anti-overdraw n'est gardé que s'il ne dégrade pas l'ACMR de plus de ce facteur
+    static constexpr float OVERDRAW_ACMR_THRESHOLD = 1.05f;
+
+    static MeshOptimizationStats optimize(std::vector<LveModel::Vertex> &vertices, std::vector<uint32_t> &indices);
+
+    static float computeACMR(const std::vector<uint32_t> &indices, uint32_t vertexCount,
+                             uint32_t cacheSize = CACHE_SIZE);
+
+    // clusters reçoit l'index du premier triangle de chaque groupe, coupé à chaque impasse de Tipsify
+    static std::vector<uint32_t> optimizeVertexCache(const std::vector<uint32_t> &indices, uint32_t vertexCount,
+                                                     std::vector<uint32_t> &clusters,
+                                                     uint32_t cacheSize = CACHE_SIZE);
+    // les groupes tournés vers l'extérieur du mesh passent en premier, ils cachent le plus souvent les autres
+    static std::vector<uint32_t> optimizeOverdraw(const std::vector<uint32_t> &indices,
+                                                  const std::vector<uint32_t> &clusters,
+                                                  const std::vector<LveModel::Vertex> &vertices);
+    // renumérote les vertex dans l'ordre des indices et retire ceux qui ne sont pas utilisés
+    static void optimizeVertexFetch(std::vector<LveModel::Vertex> &vertices, std::vector<uint32_t> &indices);
+
+    // effondre des arêtes vers un de leurs sommets jusqu'à targetIndexCount indices, sans créer de vertex. Les
+    // bords et les coutures (plusieurs vertex à la même position) ne bougent pas. error reçoit l'écart maximal en
+    // espace objet des sommets effondrés à leurs plans d'origine.
+    static std::vector<uint32_t> simplify(const std::vector<LveModel::Vertex> &vertices,
+                                          const std::vector<uint32_t> &indices, size_t targetIndexCount,
+                                          float &error);
+};
+}  // namespace lve
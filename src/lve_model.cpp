@@ -1,6 +1,7 @@
 #include "lve_model.hpp"
 
 #include "lve_descriptor.hpp"
+#include "lve_mesh_optimizer.hpp"
 #include "lve_swap_chain.hpp"
 #include "lve_texture.hpp"
 #include "lve_utils.hpp"
@@ -9,11 +10,15 @@
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
 #define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtc/packing.hpp>
 #include <glm/gtx/hash.hpp>
 
 // std
 #include <cassert>
+#include <cmath>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <unordered_map>
 
@@ -34,41 +39,140 @@ struct hash<lve::LveModel::Vertex> {
 
 namespace lve {
 
-LveModel::LveModel(LveDevice &device, const LveModel::Builder &builder) : lveDevice{device} {
-    createVertexBuffers(builder.vertices);
+// en-tête du cache .lvemesh, suivi des vertex puis des indices bruts
+struct MeshCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceStamp;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t hasVertexColors;
+    uint32_t lodCount;
+    LveModel::Bounds bounds;
+};
+
+static constexpr char MESH_CACHE_MAGIC[4] = {'L', 'V', 'E', 'M'};
+static constexpr uint32_t MESH_CACHE_VERSION = 2;
+
+// en dessous, un LOD de plus ne réduit plus assez le coût de dessin
+static constexpr uint32_t MIN_LOD_TRIANGLES = 64;
+
+// taille et date du fichier source : le cache est refait dès que l'obj change
+static uint64_t sourceFileStamp(const std::string &filepath) {
+    std::error_code error;
+    uint64_t size = std::filesystem::file_size(filepath, error);
+    if (error) return 0;
+    auto writeTime = std::filesystem::last_write_time(filepath, error);
+    if (error) return 0;
+    size_t seed = 0;
+    hashCombine(seed, size, static_cast<int64_t>(writeTime.time_since_epoch().count()));
+    return seed;
+}
+
+static int16_t quantizeSnorm16(float value) {
+    return static_cast<int16_t>(std::round(glm::clamp(value, -1.f, 1.f) * 32767.f));
+}
+
+// projection de la sphère unité sur un octaèdre déplié dans [-1, 1]², décodée par simple_shader.vert
+static glm::vec2 encodeOctahedral(glm::vec3 normal) {
+    float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (length == 0.f) {
+        return glm::vec2(0.f, 0.f);
+    }
+    glm::vec2 encoded = glm::vec2(normal) / length;
+    if (normal.z < 0.f) {
+        glm::vec2 signs{encoded.x >= 0.f ? 1.f : -1.f, encoded.y >= 0.f ? 1.f : -1.f};
+        encoded = (1.f - glm::abs(glm::vec2(encoded.y, encoded.x))) * signs;
+    }
+    return encoded;
+}
+
+LveModel::LveModel(LveDevice &device, const LveModel::Builder &builder, LveVertexFormat vertexFormat)
+    : lveDevice{device}, vertexFormat{vertexFormat}, lods{builder.lods}, bounds{builder.bounds} {
+    if (vertexFormat == LveVertexFormatStandard) {
+        createVertexBuffers(builder.vertices);
+    } else {
+        this->vertexFormat = builder.hasVertexColors ? LveVertexFormatCompressedColor : LveVertexFormatCompressed;
+        createCompressedVertexBuffers(builder.vertices);
+    }
     createIndexBuffers(builder.indices);
+    if (lods.empty()) {
+        lods.push_back({0, indexCount, 0.f});
+    }
 }
 
 LveModel::~LveModel() {}
 
-std::unique_ptr<LveModel> LveModel::createModelFromFile(LveDevice &device, const std::string &filepath) {
+std::unique_ptr<LveModel> LveModel::createModelFromFile(LveDevice &device, const std::string &filepath,
+                                                        LveVertexFormat vertexFormat) {
     Builder builder{};
     builder.loadModel(ENGINE_DIR + filepath);
-    return std::make_unique<LveModel>(device, builder);
+    return std::make_unique<LveModel>(device, builder, vertexFormat);
 }
 
-void LveModel::createVertexBuffers(const std::vector<Vertex> &vertices) {
-    vertexCount = static_cast<uint32_t>(vertices.size());
-    assert(vertexCount >= 3 && "Vertex count must be at least 3");
-    VkDeviceSize bufferSize = sizeof(vertices[0]) * vertexCount;
-    uint32_t vertexSize = sizeof(vertices[0]);
-
+std::unique_ptr<LveBuffer> LveModel::createDeviceLocalBuffer(const void *data, uint32_t instanceSize,
+                                                             uint32_t instanceCount, VkBufferUsageFlags usage) {
     LveBuffer stagingBuffer{
         lveDevice,
-        vertexSize,
-        vertexCount,
+        instanceSize,
+        instanceCount,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
     };
 
     stagingBuffer.map();
-    stagingBuffer.writeToBuffer((void *)vertices.data());
+    stagingBuffer.writeToBuffer(const_cast<void *>(data));
+
+    auto buffer = std::make_unique<LveBuffer>(lveDevice, instanceSize, instanceCount,
+                                              usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-    vertexBuffer = std::make_unique<LveBuffer>(lveDevice, vertexSize, vertexCount,
-                                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    lveDevice.copyBuffer(stagingBuffer.getBuffer(), buffer->getBuffer(),
+                         static_cast<VkDeviceSize>(instanceSize) * instanceCount);
+    return buffer;
+}
 
-    lveDevice.copyBuffer(stagingBuffer.getBuffer(), vertexBuffer->getBuffer(), bufferSize);
+void LveModel::createVertexBuffers(const std::vector<Vertex> &vertices) {
+    vertexCount = static_cast<uint32_t>(vertices.size());
+    assert(vertexCount >= 3 && "Vertex count must be at least 3");
+    vertexBuffer =
+        createDeviceLocalBuffer(vertices.data(), sizeof(vertices[0]), vertexCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+}
+
+void LveModel::createCompressedVertexBuffers(const std::vector<Vertex> &vertices) {
+    vertexCount = static_cast<uint32_t>(vertices.size());
+    assert(vertexCount >= 3 && "Vertex count must be at least 3");
+
+    float inverseRadius = bounds.radius > 0.f ? 1.f / bounds.radius : 0.f;
+    std::vector<CompressedVertex> compressedVertices(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        const Vertex &vertex = vertices[i];
+        CompressedVertex &compressed = compressedVertices[i];
+
+        glm::vec3 position = (vertex.position - bounds.center) * inverseRadius;
+        compressed.position[0] = quantizeSnorm16(position.x);
+        compressed.position[1] = quantizeSnorm16(position.y);
+        compressed.position[2] = quantizeSnorm16(position.z);
+        compressed.position[3] = 0;
+
+        glm::vec2 normal = encodeOctahedral(vertex.normal);
+        compressed.normal[0] = quantizeSnorm16(normal.x);
+        compressed.normal[1] = quantizeSnorm16(normal.y);
+
+        compressed.uv[0] = glm::packHalf1x16(vertex.uv.x);
+        compressed.uv[1] = glm::packHalf1x16(vertex.uv.y);
+    }
+    vertexBuffer = createDeviceLocalBuffer(compressedVertices.data(), sizeof(CompressedVertex), vertexCount,
+                                           VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+
+    if (vertexFormat == LveVertexFormatCompressedColor) {
+        std::vector<uint32_t> colors(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            colors[i] = glm::packUnorm4x8(glm::vec4(vertices[i].color, 1.f));
+        }
+        colorBuffer =
+            createDeviceLocalBuffer(colors.data(), sizeof(uint32_t), vertexCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    }
 }
 
 void LveModel::createIndexBuffers(const std::vector<uint32_t> &indices) {
@@ -102,16 +206,23 @@ void LveModel::createIndexBuffers(const std::vector<uint32_t> &indices) {
 
 void LveModel::draw(VkCommandBuffer commandBuffer) {
     if (hasIndexBuffer) {
-        vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+        vkCmdDrawIndexed(commandBuffer, lods[0].indexCount, 1, 0, 0, 0);
     } else {
         vkCmdDraw(commandBuffer, vertexCount, 1, 0, 0);
     }
 }
 
+void LveModel::drawIndirect(VkCommandBuffer commandBuffer, VkBuffer drawBuffer, VkDeviceSize drawOffset,
+                            VkBuffer countBuffer, VkDeviceSize countOffset, uint32_t maxDrawCount) {
+    assert(hasIndexBuffer && "Indirect drawing requires an index buffer");
+    vkCmdDrawIndexedIndirectCount(commandBuffer, drawBuffer, drawOffset, countBuffer, countOffset, maxDrawCount,
+                                  sizeof(VkDrawIndexedIndirectCommand));
+}
+
 void LveModel::bind(VkCommandBuffer commandBuffer) {
-    VkBuffer buffers[] = {vertexBuffer->getBuffer()};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+    VkBuffer buffers[] = {vertexBuffer->getBuffer(), colorBuffer ? colorBuffer->getBuffer() : VK_NULL_HANDLE};
+    VkDeviceSize offsets[] = {0, 0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, colorBuffer ? 2 : 1, buffers, offsets);
 
     if (hasIndexBuffer) {
         vkCmdBindIndexBuffer(commandBuffer, indexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
@@ -137,7 +248,139 @@ std::vector<VkVertexInputAttributeDescription> LveModel::Vertex::getAttributeDes
     return attributeDescriptions;
 }
 
+std::vector<VkVertexInputBindingDescription> LveModel::getBindingDescriptions(LveVertexFormat vertexFormat) {
+    if (vertexFormat == LveVertexFormatStandard) {
+        return Vertex::getBindingDescriptions();
+    }
+
+    std::vector<VkVertexInputBindingDescription> bindingDescriptions{};
+    bindingDescriptions.push_back({0, sizeof(CompressedVertex), VK_VERTEX_INPUT_RATE_VERTEX});
+    if (vertexFormat == LveVertexFormatCompressedColor) {
+        bindingDescriptions.push_back({1, sizeof(uint32_t), VK_VERTEX_INPUT_RATE_VERTEX});
+    }
+    return bindingDescriptions;
+}
+
+std::vector<VkVertexInputAttributeDescription> LveModel::getAttributeDescriptions(LveVertexFormat vertexFormat) {
+    if (vertexFormat == LveVertexFormatStandard) {
+        return Vertex::getAttributeDescriptions();
+    }
+
+    std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+    attributeDescriptions.push_back(
+        {0, 0, VK_FORMAT_R16G16B16A16_SNORM, offsetof(CompressedVertex, position)});
+    if (vertexFormat == LveVertexFormatCompressedColor) {
+        attributeDescriptions.push_back({1, 1, VK_FORMAT_R8G8B8A8_UNORM, 0});
+    } else {
+        // sans flux de couleur, la location 1 relit la position (déjà chargée) et le shader l'ignore
+        attributeDescriptions.push_back({1, 0, VK_FORMAT_R16G16B16A16_SNORM, offsetof(CompressedVertex, position)});
+    }
+    attributeDescriptions.push_back({2, 0, VK_FORMAT_R16G16_SNORM, offsetof(CompressedVertex, normal)});
+    attributeDescriptions.push_back({3, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(CompressedVertex, uv)});
+    return attributeDescriptions;
+}
+
 void LveModel::Builder::loadModel(const std::string &filepath) {
+    std::string cachePath = filepath + MESH_CACHE_EXTENSION;
+    uint64_t sourceStamp = sourceFileStamp(filepath);
+    if (sourceStamp != 0 && loadCache(cachePath, sourceStamp)) {
+        return;
+    }
+
+    loadObj(filepath);
+    MeshOptimizationStats stats = LveMeshOptimizer::optimize(vertices, indices);
+    std::cout << filepath << " : ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter << std::endl;
+    generateLods();
+    for (size_t lod = 0; lod < lods.size(); lod++) {
+        std::cout << "  LOD" << lod << " : " << lods[lod].indexCount / 3 << " triangles, erreur " << lods[lod].error
+                  << std::endl;
+    }
+    if (sourceStamp != 0) {
+        saveCache(cachePath, sourceStamp);
+    }
+}
+
+bool LveModel::Builder::loadCache(const std::string &cachePath, uint64_t sourceStamp) {
+    std::ifstream file{cachePath, std::ios::binary};
+    if (!file.is_open()) {
+        return false;
+    }
+
+    MeshCacheHeader header{};
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) != 0 ||
+        header.version != MESH_CACHE_VERSION || header.sourceStamp != sourceStamp || header.lodCount == 0 ||
+        header.lodCount > MAX_LODS) {
+        return false;
+    }
+
+    vertices.resize(header.vertexCount);
+    indices.resize(header.indexCount);
+    lods.resize(header.lodCount);
+    file.read(reinterpret_cast<char *>(vertices.data()), sizeof(Vertex) * header.vertexCount);
+    file.read(reinterpret_cast<char *>(indices.data()), sizeof(uint32_t) * header.indexCount);
+    file.read(reinterpret_cast<char *>(lods.data()), sizeof(Lod) * header.lodCount);
+    if (!file) {
+        vertices.clear();
+        indices.clear();
+        lods.clear();
+        return false;
+    }
+    hasVertexColors = header.hasVertexColors != 0;
+    bounds = header.bounds;
+    return true;
+}
+
+void LveModel::Builder::saveCache(const std::string &cachePath, uint64_t sourceStamp) const {
+    MeshCacheHeader header{};
+    std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+    header.version = MESH_CACHE_VERSION;
+    header.sourceStamp = sourceStamp;
+    header.vertexCount = static_cast<uint32_t>(vertices.size());
+    header.indexCount = static_cast<uint32_t>(indices.size());
+    header.hasVertexColors = hasVertexColors ? 1 : 0;
+    header.lodCount = static_cast<uint32_t>(lods.size());
+    header.bounds = bounds;
+
+    // le cache n'est qu'une accélération : un dossier en lecture seule ne doit pas empêcher le chargement
+    std::ofstream file{cachePath, std::ios::binary | std::ios::trunc};
+    if (!file.is_open()) {
+        std::cerr << "failed to write mesh cache : " << cachePath << std::endl;
+        return;
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(vertices.data()), sizeof(Vertex) * vertices.size());
+    file.write(reinterpret_cast<const char *>(indices.data()), sizeof(uint32_t) * indices.size());
+    file.write(reinterpret_cast<const char *>(lods.data()), sizeof(Lod) * lods.size());
+}
+
+void LveModel::Builder::generateLods() {
+    uint32_t baseIndexCount = static_cast<uint32_t>(indices.size());
+    lods.clear();
+    lods.push_back({0, baseIndexCount, 0.f});
+
+    // chaque LOD repart de LOD0 pour que son erreur soit mesurée par rapport au modèle complet
+    std::vector<uint32_t> baseIndices = indices;
+    std::vector<uint32_t> clusters;
+    while (lods.size() < MAX_LODS) {
+        const Lod &previous = lods.back();
+        size_t targetIndexCount = (previous.indexCount / 6) * 3;
+        if (targetIndexCount < MIN_LOD_TRIANGLES * 3) break;
+
+        float error = 0.f;
+        std::vector<uint32_t> lodIndices = LveMeshOptimizer::simplify(vertices, baseIndices, targetIndexCount, error);
+        // la simplification bloque (bords, coutures) : un LOD de plus presque identique ne sert à rien
+        if (lodIndices.size() * 10 > static_cast<size_t>(previous.indexCount) * 9) break;
+
+        lodIndices =
+            LveMeshOptimizer::optimizeVertexCache(lodIndices, static_cast<uint32_t>(vertices.size()), clusters);
+        lods.push_back({static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lodIndices.size()),
+                        std::max(error, previous.error)});
+        indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+    }
+}
+
+void LveModel::Builder::loadObj(const std::string &filepath) {
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
@@ -149,6 +392,7 @@ void LveModel::Builder::loadModel(const std::string &filepath) {
 
     vertices.clear();
     indices.clear();
+    hasVertexColors = false;
 
     std::unordered_map<Vertex, uint32_t> uniqueVertices{};
     for (const auto &shape : shapes) {
@@ -167,6 +411,8 @@ void LveModel::Builder::loadModel(const std::string &filepath) {
                     attrib.colors[3 * index.vertex_index + 1],
                     attrib.colors[3 * index.vertex_index + 2],
                 };
+                // tinyobjloader remplit les couleurs absentes avec du blanc
+                hasVertexColors = hasVertexColors || vertex.color != glm::vec3(1.f);
             }
 
             if (index.normal_index >= 0) {
@@ -191,26 +437,28 @@ void LveModel::Builder::loadModel(const std::string &filepath) {
             indices.push_back(uniqueVertices[vertex]);
         }
     }
+
+    computeBounds();
 }
 
-void LveModel::createDescriptorSet(LveDevice &lveDevice, LveTexture *texture,
-                                   LveDescriptorSetLayout *textureSetLayout) {
-    if (textureSetLayout == nullptr) {
-        textureSetLayout = LveDescriptorSetLayout::defaultTextureSetLayout.get();
+void LveModel::Builder::computeBounds() {
+    bounds = Bounds{};
+    if (vertices.empty()) {
+        return;
     }
 
-    texturePool = LveDescriptorPool::Builder(lveDevice)
-                      .setMaxSets(1)
-                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                      .build();
+    bounds.min = vertices[0].position;
+    bounds.max = vertices[0].position;
+    for (const auto &vertex : vertices) {
+        bounds.min = glm::min(bounds.min, vertex.position);
+        bounds.max = glm::max(bounds.max, vertex.position);
+    }
 
-    VkDescriptorImageInfo imageDescriptorInfo{};
-    imageDescriptorInfo.sampler = texture->getSampler();
-    imageDescriptorInfo.imageView = texture->getImageView();
-    imageDescriptorInfo.imageLayout = texture->getImageLayout();
-    LveDescriptorWriter(*textureSetLayout, *texturePool)
-        .writeImage(0, &imageDescriptorInfo)
-        .build(textureDescriptorSet);
+    // sphère centrée sur l'AABB, rayon au sommet le plus éloigné (plus serré que la demi-diagonale)
+    bounds.center = (bounds.min + bounds.max) * 0.5f;
+    for (const auto &vertex : vertices) {
+        bounds.radius = glm::max(bounds.radius, glm::length(vertex.position - bounds.center));
+    }
 }
 
 }  // namespace lve
@@ -4,12 +4,14 @@
 #include "lve_descriptor.hpp"
 #include "lve_device.hpp"
 #include "lve_texture.hpp"
+#include "lve_utils.hpp"
 // libs
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 
 // std
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -30,40 +32,101 @@ class LveModel {
         }
     };
 
+    /**
+     * Vertex compressé de 16 octets (44 pour Vertex) : position snorm16 dans la sphère englobante du modèle, normale
+     * en octaèdre snorm16, uv en demi-flottants. La couleur, rarement utilisée, va dans un flux séparé optionnel.
+     * Le vertex shader décode la position avec ObjectData.boundingSphere.
+     */
+    struct CompressedVertex {
+        int16_t position[4];  // w inutilisé, garde l'alignement
+        int16_t normal[2];
+        uint16_t uv[2];
+    };
+
+    // volumes englobants en espace objet, utilisés par le culling GPU
+    struct Bounds {
+        glm::vec3 min{0.f};
+        glm::vec3 max{0.f};
+        glm::vec3 center{0.f};
+        float radius = 0.f;
+    };
+
+    // niveau de détail : une plage du même index buffer, error est l'écart maximal à LOD0 en espace objet
+    struct Lod {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        float error;
+    };
+    static constexpr uint32_t MAX_LODS = 4;
+
     struct Builder {
         std::vector<Vertex> vertices{};
+        // LOD0 puis les LOD simplifiés, à la suite
         std::vector<uint32_t> indices{};
+        std::vector<Lod> lods{};
+        Bounds bounds{};
+        // vrai si le fichier fournit des couleurs autres que le blanc par défaut
+        bool hasVertexColors = false;
 
+        // relit le cache optimisé à côté du fichier s'il est à jour, sinon charge l'obj, l'optimise et écrit le cache
         void loadModel(const std::string &filepath);
+        void loadObj(const std::string &filepath);
+        void computeBounds();
+        // chaîne de LOD par simplification de LOD0, chacun avec environ la moitié des triangles du précédent
+        void generateLods();
+
+        bool loadCache(const std::string &cachePath, uint64_t sourceStamp);
+        void saveCache(const std::string &cachePath, uint64_t sourceStamp) const;
     };
 
-    LveModel(LveDevice &device, const LveModel::Builder &builder);
+    // fichier de cache écrit à côté du modèle source
+    static constexpr const char *MESH_CACHE_EXTENSION = ".lvemesh";
+
+    // LveVertexFormatCompressed passe à LveVertexFormatCompressedColor si le modèle a des couleurs
+    LveModel(LveDevice &device, const LveModel::Builder &builder,
+             LveVertexFormat vertexFormat = LveVertexFormatStandard);
     ~LveModel();
 
     LveModel(const LveModel &) = delete;
     LveModel &operator=(const LveModel &) = delete;
 
-    static std::unique_ptr<LveModel> createModelFromFile(LveDevice &device, const std::string &filepath);
+    static std::unique_ptr<LveModel> createModelFromFile(LveDevice &device, const std::string &filepath,
+                                                         LveVertexFormat vertexFormat = LveVertexFormatStandard);
+
+    static std::vector<VkVertexInputBindingDescription> getBindingDescriptions(LveVertexFormat vertexFormat);
+    static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions(LveVertexFormat vertexFormat);
 
     void bind(VkCommandBuffer commandBuffer);
     void draw(VkCommandBuffer commandBuffer);
+    void drawIndirect(VkCommandBuffer commandBuffer, VkBuffer drawBuffer, VkDeviceSize drawOffset, VkBuffer countBuffer,
+                      VkDeviceSize countOffset, uint32_t maxDrawCount);
 
-    void createDescriptorSet(LveDevice &lveDevice, LveTexture *texture, LveDescriptorSetLayout *textureSetLayout);
-
-    std::unique_ptr<LveDescriptorPool> texturePool;
-    VkDescriptorSet textureDescriptorSet;
+    const Bounds &getBounds() const { return bounds; }
+    bool hasIndices() const { return hasIndexBuffer; }
+    // indices du modèle complet (LOD0), l'index buffer contient aussi ceux des LOD suivants
+    uint32_t getIndexCount() const { return lods[0].indexCount; }
+    const std::vector<Lod> &getLods() const { return lods; }
+    LveVertexFormat getVertexFormat() const { return vertexFormat; }
 
    private:
     void createVertexBuffers(const std::vector<Vertex> &vertices);
+    void createCompressedVertexBuffers(const std::vector<Vertex> &vertices);
+    std::unique_ptr<LveBuffer> createDeviceLocalBuffer(const void *data, uint32_t instanceSize, uint32_t instanceCount,
+                                                       VkBufferUsageFlags usage);
     void createIndexBuffers(const std::vector<uint32_t> &indices);
 
     LveDevice &lveDevice;
 
+    LveVertexFormat vertexFormat;
     std::unique_ptr<LveBuffer> vertexBuffer;
+    std::unique_ptr<LveBuffer> colorBuffer;
     uint32_t vertexCount;
 
     bool hasIndexBuffer = false;
     std::unique_ptr<LveBuffer> indexBuffer;
     uint32_t indexCount;
+    std::vector<Lod> lods;
+
+    Bounds bounds;
 };
 }  // namespace lve
@@ -0,0 +1,217 @@
+#include "lve_noise_volume.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+#include "lve_c_pipeline.hpp"
+#include "lve_descriptor.hpp"
+#include "lve_utils.hpp"
+#include "systems/pipeline_builder.hpp"
+
+namespace lve {
+
+struct SimplePushConstantData {
+    int size;
+    int period;
+};
+
+LveNoiseVolume::LveNoiseVolume(LveDevice &device, uint32_t size, uint32_t period)
+    : lveDevice{device}, size{size}, period{period} {
+    while ((size >> mipLevels) > 0) {
+        mipLevels++;
+    }
+
+    createImage();
+    bake();
+    generateMipmaps();
+}
+
+LveNoiseVolume::~LveNoiseVolume() {
+    vkDestroySampler(lveDevice.device(), volumeSampler, nullptr);
+    vkDestroyImageView(lveDevice.device(), bakeView, nullptr);
+    vkDestroyImageView(lveDevice.device(), volumeView, nullptr);
+    vkDestroyImage(lveDevice.device(), volumeImage, nullptr);
+    vkFreeMemory(lveDevice.device(), volumeImageMemory, nullptr);
+}
+
+VkDescriptorImageInfo LveNoiseVolume::getDescriptorImageInfo() const {
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = volumeSampler;
+    imageInfo.imageView = volumeView;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    return imageInfo;
+}
+
+void LveNoiseVolume::createImage() {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_3D;
+    imageInfo.extent.width = size;
+    imageInfo.extent.height = size;
+    imageInfo.extent.depth = size;
+    imageInfo.mipLevels = mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                      VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    lveDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, volumeImage, volumeImageMemory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = volumeImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_3D;
+    viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1};
+    if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &volumeView) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create noise volume image view!");
+    }
+
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &bakeView) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create noise volume bake view!");
+    }
+
+    // REPEAT : le volume est périodique, l'échantillonnage en p / period le fait tuiler dans tout l'espace
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.compareOp = VK_COMPARE_OP_NEVER;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = static_cast<float>(mipLevels);
+    samplerInfo.anisotropyEnable = VK_FALSE;
+    samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+    if (vkCreateSampler(lveDevice.device(), &samplerInfo, nullptr, &volumeSampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create noise volume sampler!");
+    }
+}
+
+void LveNoiseVolume::bake() {
+    auto bakeSetLayout = LveDescriptorSetLayout::Builder(lveDevice)
+                             .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+                             .build();
+    auto bakePool = LveDescriptorPool::Builder(lveDevice)
+                        .setMaxSets(1)
+                        .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1)
+                        .build();
+
+    VkDescriptorImageInfo bakeInfo{};
+    bakeInfo.imageView = bakeView;
+    bakeInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    VkDescriptorSet bakeDescriptorSet;
+    LveDescriptorWriter(*bakeSetLayout, *bakePool).writeImage(0, &bakeInfo).build(bakeDescriptorSet);
+
+    PipelineCreateInfo pipelineCreateInfo{lveDevice,
+                                          LvePipeLineType::LvePipeLineTypeCompute,
+                                          {bakeSetLayout->getDescriptorSetLayout()},
+                                          {"shaders/noise_bake.comp.spv"},
+                                          sizeof(SimplePushConstantData),
+                                          LvePipelIneFunctionnality::None,
+                                          nullptr};
+    VkPipelineLayout pipelineLayout = PipelineBuilder::BuildPipeLineLayout(pipelineCreateInfo);
+    std::unique_ptr<LveCPipeline> bakePipeline =
+        PipelineBuilder::BuildComputesPipeline(pipelineCreateInfo, pipelineLayout);
+
+    VkCommandBuffer commandBuffer = lveDevice.beginSingleTimeCommands();
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = volumeImage;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+
+    bakePipeline->bind(commandBuffer);
+    SimplePushConstantData push{};
+    push.size = static_cast<int>(size);
+    push.period = static_cast<int>(period);
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SimplePushConstantData),
+                       &push);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &bakeDescriptorSet, 0,
+                            nullptr);
+    uint32_t groupCount = (size + 3) / 4;
+    vkCmdDispatch(commandBuffer, groupCount, groupCount, groupCount);
+
+    lveDevice.endSingleTimeCommands(commandBuffer);
+
+    vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr);
+}
+
+void LveNoiseVolume::generateMipmaps() {
+    VkCommandBuffer commandBuffer = lveDevice.beginSingleTimeCommands();
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = volumeImage;
+
+    // mip 0 : écrit par le compute shader, source du premier blit
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+
+    int32_t mipSize = static_cast<int32_t>(size);
+    for (uint32_t level = 1; level < mipLevels; level++) {
+        int32_t nextSize = std::max(mipSize / 2, 1);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1};
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+
+        VkImageBlit blit{};
+        blit.srcOffsets[1] = {mipSize, mipSize, mipSize};
+        blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1};
+        blit.dstOffsets[1] = {nextSize, nextSize, nextSize};
+        blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+        vkCmdBlitImage(commandBuffer, volumeImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, volumeImage,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+
+        mipSize = nextSize;
+    }
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+
+    lveDevice.endSingleTimeCommands(commandBuffer);
+}
+
+}  // namespace lve
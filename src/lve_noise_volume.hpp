@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+
+#include "lve_device.hpp"
+
+namespace lve {
+/**
+ * Volume 3D de bruit répétable précalculé au lancement par noise_bake.comp, avec sa chaîne de mips. Les raymarchers
+ * le lisent avec le filtrage trilinéaire du sampler au lieu d'évaluer 8 hash par octave à chaque pas.
+ * rgb : Noise3D de clouds.comp, a : fbm de 4 octaves.
+ */
+class LveNoiseVolume {
+   public:
+    static constexpr uint32_t DEFAULT_SIZE = 64;
+    // cellules du réseau par côté, soit DEFAULT_SIZE / DEFAULT_PERIOD texels par cellule
+    static constexpr uint32_t DEFAULT_PERIOD = 16;
+
+    LveNoiseVolume(LveDevice &device, uint32_t size = DEFAULT_SIZE, uint32_t period = DEFAULT_PERIOD);
+    ~LveNoiseVolume();
+
+    LveNoiseVolume(const LveNoiseVolume &) = delete;
+    LveNoiseVolume &operator=(const LveNoiseVolume &) = delete;
+
+    // en SHADER_READ_ONLY_OPTIMAL, sampler trilinéaire en REPEAT
+    VkDescriptorImageInfo getDescriptorImageInfo() const;
+    uint32_t getPeriod() const { return period; }
+
+   private:
+    void createImage();
+    void bake();
+    void generateMipmaps();
+
+    LveDevice &lveDevice;
+
+    uint32_t size;
+    uint32_t period;
+    uint32_t mipLevels = 1;
+
+    VkImage volumeImage = VK_NULL_HANDLE;
+    VkDeviceMemory volumeImageMemory = VK_NULL_HANDLE;
+    VkImageView volumeView = VK_NULL_HANDLE;
+    VkImageView bakeView = VK_NULL_HANDLE;  // mip 0 seul, écrit par le compute shader
+    VkSampler volumeSampler = VK_NULL_HANDLE;
+};
+}  // namespace lve
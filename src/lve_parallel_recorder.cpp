@@ -0,0 +1,135 @@
+#include "lve_parallel_recorder.hpp"
+
+#include <stdexcept>
+
+#include "lve_swap_chain.hpp"
+
+namespace lve {
+
+LveParallelRecorder::LveParallelRecorder(LveDevice &device, uint32_t threadCount) : lveDevice{device} {
+    framePools.resize(threadCount);
+    for (auto &pools : framePools) {
+        pools.resize(LveSwapChain::getFramesInFlight());
+        for (auto &framePool : pools) {
+            framePool.pool = lveDevice.createCommandPool(VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+        }
+    }
+
+    for (uint32_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(&LveParallelRecorder::workerLoop, this, i);
+    }
+}
+
+LveParallelRecorder::~LveParallelRecorder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // détruire un pool libère ses command buffers
+    for (auto &pools : framePools) {
+        for (auto &framePool : pools) {
+            vkDestroyCommandPool(lveDevice.device(), framePool.pool, nullptr);
+        }
+    }
+}
+
+void LveParallelRecorder::beginFrame(int frameIndex) {
+    currentFrameIndex = frameIndex;
+    for (auto &pools : framePools) {
+        FramePool &framePool = pools[frameIndex];
+        vkResetCommandPool(lveDevice.device(), framePool.pool, 0);
+        framePool.usedCommandBuffers = 0;
+    }
+}
+
+VkCommandBuffer LveParallelRecorder::acquireCommandBuffer(uint32_t threadIndex) {
+    FramePool &framePool = framePools[threadIndex][currentFrameIndex];
+    if (framePool.usedCommandBuffers == framePool.commandBuffers.size()) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandPool = framePool.pool;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        if (vkAllocateCommandBuffers(lveDevice.device(), &allocInfo, &commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate secondary command buffer!");
+        }
+        framePool.commandBuffers.push_back(commandBuffer);
+    }
+    return framePool.commandBuffers[framePool.usedCommandBuffers++];
+}
+
+std::vector<VkCommandBuffer> LveParallelRecorder::record(const VkCommandBufferInheritanceInfo &inheritanceInfo,
+                                                         const std::vector<Recorder> &recorders) {
+    std::unique_lock<std::mutex> lock(mutex);
+    currentRecorders = &recorders;
+    currentInheritanceInfo = &inheritanceInfo;
+    recordedCommandBuffers.assign(recorders.size(), VK_NULL_HANDLE);
+    pendingThreads = static_cast<uint32_t>(threads.size());
+    generation++;
+    workAvailable.notify_all();
+
+    workDone.wait(lock, [this] { return pendingThreads == 0; });
+    currentRecorders = nullptr;
+    currentInheritanceInfo = nullptr;
+    if (workerError) {
+        std::exception_ptr error = workerError;
+        workerError = nullptr;
+        std::rethrow_exception(error);
+    }
+    return recordedCommandBuffers;
+}
+
+void LveParallelRecorder::workerLoop(uint32_t threadIndex) {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        // les tâches et la frame ne changent pas tant que record attend ce thread
+        std::exception_ptr error;
+        try {
+            for (size_t task = threadIndex; task < currentRecorders->size(); task += threads.size()) {
+                VkCommandBuffer commandBuffer = acquireCommandBuffer(threadIndex);
+
+                VkCommandBufferBeginInfo beginInfo{};
+                beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+                beginInfo.flags =
+                    VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+                beginInfo.pInheritanceInfo = currentInheritanceInfo;
+                if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+                    throw std::runtime_error("failed to begin recording secondary command buffer!");
+                }
+                (*currentRecorders)[task](commandBuffer);
+                if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+                    throw std::runtime_error("failed to record secondary command buffer!");
+                }
+                recordedCommandBuffers[task] = commandBuffer;
+            }
+        } catch (...) {
+            // une exception sortant du thread appellerait std::terminate et record attendrait ce thread pour toujours
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error && !workerError) {
+                workerError = error;
+            }
+            pendingThreads--;
+        }
+        workDone.notify_one();
+    }
+}
+
+}  // namespace lve
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "lve_device.hpp"
+
+namespace lve {
+/**
+ * Enregistre des secondary command buffers en parallèle. Chaque thread possède un command pool par frame in flight,
+ * remis à zéro au début de la frame, les command buffers sont rendus dans l'ordre des tâches.
+ */
+class LveParallelRecorder {
+   public:
+    using Recorder = std::function<void(VkCommandBuffer)>;
+
+    LveParallelRecorder(LveDevice &device, uint32_t threadCount);
+    ~LveParallelRecorder();
+
+    LveParallelRecorder(const LveParallelRecorder &) = delete;
+    LveParallelRecorder &operator=(const LveParallelRecorder &) = delete;
+
+    // la frame précédente de ce slot doit être terminée
+    void beginFrame(int frameIndex);
+    // une exception levée par un thread d'enregistrement est relancée ici, sur le thread appelant
+    std::vector<VkCommandBuffer> record(const VkCommandBufferInheritanceInfo &inheritanceInfo,
+                                        const std::vector<Recorder> &recorders);
+
+    uint32_t getThreadCount() const { return static_cast<uint32_t>(threads.size()); }
+
+   private:
+    struct FramePool {
+        VkCommandPool pool;
+        std::vector<VkCommandBuffer> commandBuffers;
+        uint32_t usedCommandBuffers = 0;
+    };
+
+    void workerLoop(uint32_t threadIndex);
+    VkCommandBuffer acquireCommandBuffer(uint32_t threadIndex);
+
+    LveDevice &lveDevice;
+    int currentFrameIndex = 0;
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<FramePool>> framePools;  // [thread][frame]
+
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workDone;
+    uint64_t generation = 0;
+    uint32_t pendingThreads = 0;
+    bool stopping = false;
+
+    // tâches en cours, la tâche i est enregistrée par le thread i % threadCount
+    const std::vector<Recorder> *currentRecorders = nullptr;
+    const VkCommandBufferInheritanceInfo *currentInheritanceInfo = nullptr;
+    std::vector<VkCommandBuffer> recordedCommandBuffers;
+    // première exception levée par un thread pendant record
+    std::exception_ptr workerError;
+};
+}  // namespace lve
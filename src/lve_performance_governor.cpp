@@ -0,0 +1,76 @@
+#include "lve_performance_governor.hpp"
+
+#include <array>
+
+namespace lve {
+
+// du plus beau au plus rapide
+static const std::array<QualitySettings, LvePerformanceGovernor::QUALITY_LEVEL_COUNT> QUALITY_LEVELS{{
+    {1.f, 200, 1},
+    {1.f, 128, 1},
+    {.85f, 128, 2},
+    {.75f, 96, 2},
+    {.6f, 64, 3},
+    {.5f, 48, 4},
+}};
+
+static constexpr float SMOOTHING = 0.1f;
+// au-dessus du budget on baisse la qualité, il faut une vraie marge pour la remonter
+static constexpr float DOWNGRADE_THRESHOLD = 1.05f;
+static constexpr float UPGRADE_THRESHOLD = 0.75f;
+static constexpr uint32_t DOWNGRADE_FRAMES = 20;
+static constexpr uint32_t UPGRADE_FRAMES = 120;
+// laisse la moyenne lissée rattraper le nouveau niveau avant de juger à nouveau
+static constexpr uint32_t COOLDOWN_FRAMES = 60;
+
+LvePerformanceGovernor::LvePerformanceGovernor(float budgetMs) {
+    telemetry.budgetMs = budgetMs;
+    telemetry.settings = QUALITY_LEVELS[0];
+}
+
+bool LvePerformanceGovernor::update(float gpuTimeMs) {
+    telemetry.frame++;
+    telemetry.gpuTimeMs = gpuTimeMs;
+    telemetry.smoothedGpuTimeMs = telemetry.frame == 1
+                                      ? gpuTimeMs
+                                      : telemetry.smoothedGpuTimeMs + (gpuTimeMs - telemetry.smoothedGpuTimeMs) * SMOOTHING;
+
+    if (cooldownFrames > 0) {
+        cooldownFrames--;
+        return false;
+    }
+
+    float smoothed = telemetry.smoothedGpuTimeMs;
+    overBudgetFrames = smoothed > telemetry.budgetMs * DOWNGRADE_THRESHOLD ? overBudgetFrames + 1 : 0;
+    underBudgetFrames = smoothed < telemetry.budgetMs * UPGRADE_THRESHOLD ? underBudgetFrames + 1 : 0;
+
+    if (overBudgetFrames >= DOWNGRADE_FRAMES && telemetry.qualityLevel < QUALITY_LEVEL_COUNT - 1) {
+        setLevel(telemetry.qualityLevel + 1, GovernorDecisionDowngrade);
+        return true;
+    }
+    if (underBudgetFrames >= UPGRADE_FRAMES && telemetry.qualityLevel > 0) {
+        setLevel(telemetry.qualityLevel - 1, GovernorDecisionUpgrade);
+        return true;
+    }
+    return false;
+}
+
+void LvePerformanceGovernor::setLevel(int level, GovernorDecision decision) {
+    decisionHistory.push_back(
+        {telemetry.frame, decision, telemetry.qualityLevel, level, telemetry.smoothedGpuTimeMs});
+    if (decisionHistory.size() > MAX_DECISION_HISTORY) {
+        decisionHistory.pop_front();
+    }
+
+    telemetry.qualityLevel = level;
+    telemetry.settings = QUALITY_LEVELS[level];
+    telemetry.lastDecision = decision;
+    telemetry.lastDecisionFrame = telemetry.frame;
+    telemetry.decisionCount++;
+
+    overBudgetFrames = 0;
+    underBudgetFrames = 0;
+    cooldownFrames = COOLDOWN_FRAMES;
+}
+
+}  // namespace lve
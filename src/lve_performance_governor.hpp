@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace lve {
+
+// réglages appliqués par FirstApp à chaque changement de niveau
+struct QualitySettings {
+    float renderScale;          // fraction de la swapchain rendue par la passe principale, remise à l'échelle en post
+    int cloudSteps;             // pas maximum de la raymarche de clouds.comp
+    int cascadeUpdateInterval;  // les cascades de détail ne sont recalculées qu'une paire de frames sur n
+};
+
+enum GovernorDecision {
+    GovernorDecisionNone = 0,
+    GovernorDecisionDowngrade = 1,
+    GovernorDecisionUpgrade = 2,
+};
+
+struct GovernorTelemetry {
+    uint64_t frame = 0;  // nombre de mesures reçues
+    float gpuTimeMs = 0.f;
+    float smoothedGpuTimeMs = 0.f;
+    float budgetMs = 0.f;
+    int qualityLevel = 0;
+    QualitySettings settings{};
+    GovernorDecision lastDecision = GovernorDecisionNone;
+    uint64_t lastDecisionFrame = 0;
+    uint32_t decisionCount = 0;
+};
+
+/**
+ * Ajuste la qualité du rendu pour tenir un budget de temps GPU. Le temps mesuré est lissé et le niveau de qualité ne
+ * change qu'après un dépassement (ou une marge) soutenu, suivi d'une période de stabilisation, pour éviter
+ * d'osciller entre deux niveaux.
+ */
+class LvePerformanceGovernor {
+   public:
+    static constexpr int QUALITY_LEVEL_COUNT = 6;
+    static constexpr size_t MAX_DECISION_HISTORY = 32;
+
+    struct DecisionRecord {
+        uint64_t frame;
+        GovernorDecision decision;
+        int fromLevel;
+        int toLevel;
+        float smoothedGpuTimeMs;
+    };
+
+    LvePerformanceGovernor(float budgetMs);
+
+    // une mesure de temps GPU par frame, renvoie true si les réglages ont changé
+    bool update(float gpuTimeMs);
+
+    void setBudget(float budgetMs) { telemetry.budgetMs = budgetMs; }
+    const QualitySettings &getSettings() const { return telemetry.settings; }
+    const GovernorTelemetry &getTelemetry() const { return telemetry; }
+    const std::deque<DecisionRecord> &getDecisionHistory() const { return decisionHistory; }
+
+   private:
+    void setLevel(int level, GovernorDecision decision);
+
+    GovernorTelemetry telemetry;
+    std::deque<DecisionRecord> decisionHistory;
+
+    uint32_t overBudgetFrames = 0;
+    uint32_t underBudgetFrames = 0;
+    uint32_t cooldownFrames = 0;
+};
+}  // namespace lve
@@ -0,0 +1,154 @@
+#include "lve_post_fusion.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+#include "lve_utils.hpp"
+#include "systems/pipeline_builder.hpp"
+
+#ifndef ENGINE_DIR
+#define ENGINE_DIR "../"
+#endif
+
+// chemin trouvé par CMake, sinon celui du PATH
+#ifndef LVE_GLSL_VALIDATOR
+#define LVE_GLSL_VALIDATOR "glslangValidator"
+#endif
+
+namespace lve {
+
+namespace {
+const std::string FUSED_SHADER_DIR = "fused_shaders/";
+}
+
+LvePostFusion::LvePostFusion(LveDevice &device, VkDescriptorSetLayout textureSetLayout,
+                             VkDescriptorSetLayout depthSetLayout)
+    : lveDevice{device} {
+    PipelineCreateInfo pipelineCreateInfo{device,
+                                          LvePipeLineType::LvePipeLineTypeCompute,
+                                          {textureSetLayout, depthSetLayout},
+                                          {},
+                                          PUSH_CONSTANT_SIZE,
+                                          LvePipelIneFunctionnality::None,
+                                          nullptr};
+    pipelineLayout = PipelineBuilder::BuildPipeLineLayout(pipelineCreateInfo);
+}
+
+LvePostFusion::~LvePostFusion() {
+    pipelines.clear();
+    vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr);
+}
+
+LveCPipeline *LvePostFusion::getPipeline(const std::vector<std::string> &pixelFunctions) {
+    if (pixelFunctions.empty() || pixelFunctions.size() > MAX_FUSED_EFFECTS) {
+        return nullptr;
+    }
+
+    std::string source = generateSource(pixelFunctions);
+    auto pipeline = pipelines.find(source);
+    if (pipeline != pipelines.end()) {
+        return pipeline->second.get();
+    }
+
+    std::unique_ptr<LveCPipeline> fusedPipeline;
+    std::string spirvPath = compile(source);
+    if (!spirvPath.empty()) {
+        PipelineCreateInfo pipelineCreateInfo{lveDevice,
+                                              LvePipeLineType::LvePipeLineTypeCompute,
+                                              {},
+                                              {spirvPath},
+                                              PUSH_CONSTANT_SIZE,
+                                              LvePipelIneFunctionnality::None,
+                                              nullptr};
+        fusedPipeline = PipelineBuilder::BuildComputesPipeline(pipelineCreateInfo, pipelineLayout);
+    }
+    return pipelines.emplace(source, std::move(fusedPipeline)).first->second.get();
+}
+
+void LvePostFusion::dispatch(VkCommandBuffer commandBuffer, LveCPipeline &pipeline,
+                             const std::vector<glm::vec4> &parameters, VkDescriptorSet textureDescriptorSet,
+                             VkDescriptorSet depthDescriptorSet, VkExtent2D extent) {
+    VkDescriptorSet descriptorSet[] = {textureDescriptorSet, depthDescriptorSet};
+
+    pipeline.bind(commandBuffer);
+
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                       static_cast<uint32_t>(parameters.size() * sizeof(glm::vec4)), parameters.data());
+
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 2, descriptorSet, 0,
+                            nullptr);
+
+    vkCmdDispatch(commandBuffer, (extent.width + 15) / 16, (extent.height + 15) / 16, 1);
+}
+
+std::string LvePostFusion::generateSource(const std::vector<std::string> &pixelFunctions) {
+    std::ostringstream source;
+    source << "#version 450\n"
+           << "#extension GL_GOOGLE_include_directive : require\n\n"
+           << "#include \"pixel_effect_layout.glsl\"\n\n";
+
+    // chaque effet définit effect, renommé pour qu'ils coexistent
+    for (size_t i = 0; i < pixelFunctions.size(); i++) {
+        source << "#define effect effect" << i << "\n" << pixelFunctions[i] << "\n#undef effect\n\n";
+    }
+
+    source << "void main() {\n"
+           << "    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);\n"
+           << "    ivec2 size = imageSize(outputImage);\n"
+           << "    if (any(greaterThanEqual(pixel, size))) {\n"
+           << "        return;\n"
+           << "    }\n\n"
+           << "    vec4 color = imageLoad(inputImage, pixel);\n";
+    for (size_t i = 0; i < pixelFunctions.size(); i++) {
+        source << "    color = effect" << i << "(color, pixel, size, push.params[" << i << "]);\n";
+    }
+    source << "    imageStore(outputImage, pixel, color);\n"
+           << "}\n";
+    return source.str();
+}
+
+std::string LvePostFusion::compile(const std::string &source) {
+    std::string name = "fused_" + std::to_string(std::hash<std::string>{}(source)) + ".comp";
+    std::string sourcePath = ENGINE_DIR + FUSED_SHADER_DIR + name;
+    std::string spirvPath = FUSED_SHADER_DIR + name + ".spv";
+
+    // déjà compilé par un lancement précédent
+    std::ifstream previousSource{sourcePath};
+    if (previousSource.is_open() && std::filesystem::exists(ENGINE_DIR + spirvPath)) {
+        std::stringstream previous;
+        previous << previousSource.rdbuf();
+        if (previous.str() == source) {
+            return spirvPath;
+        }
+    }
+    previousSource.close();
+
+    std::error_code error;
+    std::filesystem::create_directories(ENGINE_DIR + FUSED_SHADER_DIR, error);
+    std::ofstream sourceFile{sourcePath, std::ios::trunc};
+    if (!sourceFile.is_open()) {
+        std::cerr << "post fusion : cannot write " << sourcePath << std::endl;
+        return {};
+    }
+    sourceFile << source;
+    sourceFile.close();
+
+    std::string command = std::string{"\""} + LVE_GLSL_VALIDATOR + "\" -V -I\"" + ENGINE_DIR + "shaders\" \"" +
+                          sourcePath + "\" -o \"" + ENGINE_DIR + spirvPath + "\"";
+#ifdef _WIN32
+    // cmd retire le premier et le dernier guillemet de la ligne
+    command = "\"" + command + "\"";
+#endif
+    if (std::system(command.c_str()) != 0) {
+        std::cerr << "post fusion : failed to compile " << sourcePath << ", effects run separately" << std::endl;
+        std::filesystem::remove(ENGINE_DIR + spirvPath, error);
+        return {};
+    }
+    return spirvPath;
+}
+
+}  // namespace lve
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "lve_c_pipeline.hpp"
+#include "lve_device.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+namespace lve {
+/**
+ * Fusion des effets de post-processing par pixel (LveIPostProcessing::getPixelFunction) : un compute shader qui
+ * enchaîne leurs fonctions est généré puis compilé avec glslangValidator au premier besoin, les pixels ne passent
+ * plus par les images intermédiaires entre deux effets. Les shaders générés restent dans fused_shaders/ et sont
+ * réutilisés aux lancements suivants tant que leur source ne change pas.
+ */
+class LvePostFusion {
+   public:
+    // un vec4 de params par effet, 128 octets de push constants garantis par Vulkan
+    static constexpr uint32_t MAX_FUSED_EFFECTS = 8;
+    static constexpr uint32_t PUSH_CONSTANT_SIZE = MAX_FUSED_EFFECTS * sizeof(glm::vec4);
+
+    LvePostFusion(LveDevice &device, VkDescriptorSetLayout textureSetLayout, VkDescriptorSetLayout depthSetLayout);
+    ~LvePostFusion();
+
+    LvePostFusion(const LvePostFusion &) = delete;
+    LvePostFusion &operator=(const LvePostFusion &) = delete;
+
+    // nullptr si le shader n'a pas pu être compilé, l'échec est gardé pour ne pas relancer le compilateur
+    LveCPipeline *getPipeline(const std::vector<std::string> &pixelFunctions);
+
+    void dispatch(VkCommandBuffer commandBuffer, LveCPipeline &pipeline, const std::vector<glm::vec4> &parameters,
+                  VkDescriptorSet textureDescriptorSet, VkDescriptorSet depthDescriptorSet, VkExtent2D extent);
+
+   private:
+    static std::string generateSource(const std::vector<std::string> &pixelFunctions);
+    // chemin du SPIR-V pour LveCPipeline, vide en cas d'échec
+    static std::string compile(const std::string &source);
+
+    LveDevice &lveDevice;
+    VkPipelineLayout pipelineLayout;
+    // indexé par la source générée
+    std::unordered_map<std::string, std::unique_ptr<LveCPipeline>> pipelines;
+};
+}  // namespace lve
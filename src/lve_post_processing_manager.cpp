@@ -2,117 +2,226 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 
 #include "lve_swap_chain.hpp"
 #include "lve_utils.hpp"
 
 namespace lve {
-LvePostProcessingManager::LvePostProcessingManager(LveDevice &lveDevice, VkExtent2D windowExtent,
-                                                   std::vector<VkImageView> depthImageViews,
-                                                   std::vector<VkSampler> depthSamplers)
-    : lveDevice{lveDevice}, windowExtent{windowExtent} {
-    createTexture();
+LvePostProcessingManager::LvePostProcessingManager(LveDevice &lveDevice, LveSwapChain &swapChain)
+    : lveDevice{lveDevice},
+      windowExtent{swapChain.getSwapChainExtent()},
+      imageCount{swapChain.imageCount()},
+      outputMode{swapChain.hasStorageOutput() ? LvePostOutputStorage : LvePostOutputCopy},
+      blitOutput{swapChain.needsOutputBlit()},
+      outdatedFrames(LveSwapChain::getFramesInFlight(), false),
+      sceneViews{swapChain.getSceneColorStorageViews()},
+      swapChainViews{swapChain.getStorageImageViews()} {
+    createTexture(swapChain.getSceneColorFormat());
 
     createDescriptorPool();
 
-    createDescriptorSet(depthImageViews, depthSamplers);
+    allocateDescriptorSets();
+    for (int frame = 0; frame < LveSwapChain::getFramesInFlight(); frame++) {
+        writeDescriptorSets(frame);
+    }
 
-    createImageBarrier();
+    createLinearDepth(swapChain);
 
-    createSyncObjects();
+    postFusion = std::make_unique<LvePostFusion>(
+        lveDevice, LveDescriptorSetLayout::defaultPostProcessingTextureSetLayout->getDescriptorSetLayout(),
+        LveDescriptorSetLayout::linearDepthSetLayout->getDescriptorSetLayout());
 }
 
-LvePostProcessingManager::LvePostProcessingManager(VkExtent2D windowExtent,
-                                                   LvePostProcessingManager &postProcessingManager,
-                                                   std::vector<VkImageView> depthImageViews,
-                                                   std::vector<VkSampler> depthSamplers)
-    : lveDevice{postProcessingManager.lveDevice},
-      windowExtent{windowExtent},
-      postProcessings{postProcessingManager.postProcessings} {
-    createTexture();
+LvePostProcessingManager::~LvePostProcessingManager() {}
+
+void LvePostProcessingManager::resize(LveSwapChain &swapChain) {
+    windowExtent = swapChain.getSwapChainExtent();
+    blitOutput = swapChain.needsOutputBlit();
+    sceneViews = swapChain.getSceneColorStorageViews();
+    swapChainViews = swapChain.getStorageImageViews();
+
+    // les sets déjà alloués suffisent tant que le nombre d'images de la swapchain et la sortie ne changent pas
+    LvePostOutputMode newOutputMode = swapChain.hasStorageOutput() ? LvePostOutputStorage : LvePostOutputCopy;
+    if (swapChain.imageCount() != imageCount || newOutputMode != outputMode) {
+        imageCount = swapChain.imageCount();
+        outputMode = newOutputMode;
+        std::shared_ptr<LveDescriptorPool> oldPool = std::move(postprocessingPool);
+        lveDevice.retire([oldPool]() {});
+        createDescriptorPool();
+        allocateDescriptorSets();
+    }
+    std::fill(outdatedFrames.begin(), outdatedFrames.end(), true);
 
-    createDescriptorPool();
+    linearDepth->resize(windowExtent, swapChain.getDepthImageViews(), swapChain.getDepthImagesSamplers());
 
-    createDescriptorSet(depthImageViews, depthSamplers);
+    for (auto &postProcessing : postProcessings) {
+        postProcessing->resize(windowExtent);
+    }
+}
 
-    createImageBarrier();
+void LvePostProcessingManager::createTexture(VkFormat textureFormat) {
+    // même format que la cible de scène pour que l'agrandissement et la copie finale restent des transferts bruts
+    textures.resize(LveSwapChain::getFramesInFlight());
+    for (int i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
+        textures[i] =
+            std::make_unique<LveTexture>(lveDevice, windowExtent.width, windowExtent.height, textureFormat);
+    }
+}
 
-    createSyncObjects();
+void LvePostProcessingManager::createDescriptorPool() {
+    uint32_t pairCount = static_cast<uint32_t>(LveSwapChain::getFramesInFlight() * imageCount);
+    postprocessingPool = LveDescriptorPool::Builder(lveDevice)
+                             .setMaxSets(pairCount * 4)
+                             .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, pairCount * 8)
+                             .build();
 }
 
-LvePostProcessingManager::~LvePostProcessingManager() {
-    for (size_t i = 0; i < LveSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
-        vkDestroySemaphore(lveDevice.device(), computeFinishedSemaphores[i], nullptr);
+void LvePostProcessingManager::allocateDescriptorSets() {
+    VkDescriptorSetLayout layout =
+        LveDescriptorSetLayout::defaultPostProcessingTextureSetLayout->getDescriptorSetLayout();
+
+    texturesDescriptorSets.resize(LveSwapChain::getFramesInFlight() * imageCount);
+    for (auto &descriptorSets : texturesDescriptorSets) {
+        postprocessingPool->allocateDescriptor(layout, descriptorSets.first);
+        postprocessingPool->allocateDescriptor(layout, descriptorSets.second);
     }
-}
 
-void LvePostProcessingManager::createTexture() {
-    textures.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT * 2);
-    for (int i = 0; i < LveSwapChain::MAX_FRAMES_IN_FLIGHT * 2; i++) {
-        textures[i] = std::make_unique<LveTexture>(lveDevice, windowExtent.width, windowExtent.height);
+    outputDescriptorSets.clear();
+    if (outputMode != LvePostOutputStorage) return;
+    outputDescriptorSets.resize(LveSwapChain::getFramesInFlight() * imageCount);
+    for (auto &descriptorSets : outputDescriptorSets) {
+        postprocessingPool->allocateDescriptor(layout, descriptorSets.first);
+        postprocessingPool->allocateDescriptor(layout, descriptorSets.second);
     }
 }
 
-void LvePostProcessingManager::createDescriptorPool() {
-    postprocessingPool =
-        LveDescriptorPool::Builder(lveDevice)
-            .setMaxSets(LveSwapChain::MAX_FRAMES_IN_FLIGHT * 2 + 6)
-            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT * 2)
-            .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT * 2)
-            .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT * 4)
-            .build();
-}
+void LvePostProcessingManager::writeDescriptorSets(int frame) {
+    for (size_t image = 0; image < imageCount; image++) {
+        VkDescriptorImageInfo sceneDescriptorInfo{};
+        sceneDescriptorInfo.imageView = sceneViews[image];
+        sceneDescriptorInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorImageInfo textureDescriptorInfo{};
+        textureDescriptorInfo.imageView = textures[frame]->getImageView();
+        textureDescriptorInfo.imageLayout = textures[frame]->getImageLayout();
 
-void LvePostProcessingManager::createDescriptorSet(std::vector<VkImageView> depthImageViews,
-                                                   std::vector<VkSampler> depthSamplers) {
-    texturesDescriptorSets.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+        size_t index = frame * imageCount + image;
+        LveDescriptorWriter(*LveDescriptorSetLayout::defaultPostProcessingTextureSetLayout, *postprocessingPool)
+            .writeImage(0, &sceneDescriptorInfo)
+            .writeImage(1, &textureDescriptorInfo)
+            .overwrite(texturesDescriptorSets[index].first);
+
+        LveDescriptorWriter(*LveDescriptorSetLayout::defaultPostProcessingTextureSetLayout, *postprocessingPool)
+            .writeImage(0, &textureDescriptorInfo)
+            .writeImage(1, &sceneDescriptorInfo)
+            .overwrite(texturesDescriptorSets[index].second);
 
-    for (int i = 0; i < LveSwapChain::MAX_FRAMES_IN_FLIGHT * 2; i += 2) {
-        VkDescriptorImageInfo imageDescriptorInfo1{};
-        imageDescriptorInfo1.imageView = textures[i]->getImageView();
-        imageDescriptorInfo1.imageLayout = textures[i]->getImageLayout();
+        if (outputMode != LvePostOutputStorage) continue;
 
-        VkDescriptorImageInfo imageDescriptorInfo2{};
-        imageDescriptorInfo2.imageView = textures[i + 1]->getImageView();
-        imageDescriptorInfo2.imageLayout = textures[i + 1]->getImageLayout();
+        VkDescriptorImageInfo swapChainDescriptorInfo{};
+        swapChainDescriptorInfo.imageView = swapChainViews[image];
+        swapChainDescriptorInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 
-        VkDescriptorSet textureDescriptorSet1;
-        VkDescriptorSet textureDescriptorSet2;
         LveDescriptorWriter(*LveDescriptorSetLayout::defaultPostProcessingTextureSetLayout, *postprocessingPool)
-            .writeImage(0, &imageDescriptorInfo1)
-            .writeImage(1, &imageDescriptorInfo2)
-            .build(textureDescriptorSet1);
+            .writeImage(0, &sceneDescriptorInfo)
+            .writeImage(1, &swapChainDescriptorInfo)
+            .overwrite(outputDescriptorSets[index].first);
 
         LveDescriptorWriter(*LveDescriptorSetLayout::defaultPostProcessingTextureSetLayout, *postprocessingPool)
-            .writeImage(0, &imageDescriptorInfo2)
-            .writeImage(1, &imageDescriptorInfo1)
-            .build(textureDescriptorSet2);
-        texturesDescriptorSets[i / 2] = std::make_pair(textureDescriptorSet1, textureDescriptorSet2);
+            .writeImage(0, &textureDescriptorInfo)
+            .writeImage(1, &swapChainDescriptorInfo)
+            .overwrite(outputDescriptorSets[index].second);
     }
+}
 
-    depthDescriptorSets.resize(depthSamplers.size());
-    for (int i = 0; i < depthSamplers.size(); i++) {
-        VkDescriptorImageInfo depthImageDescriptorInfo{};
-        depthImageDescriptorInfo.sampler = depthSamplers[i];
-        depthImageDescriptorInfo.imageView = depthImageViews[i];
-        depthImageDescriptorInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+void LvePostProcessingManager::createLinearDepth(LveSwapChain &swapChain) {
+    linearDepth = std::make_unique<LveLinearDepth>(lveDevice, windowExtent, swapChain.getDepthImageViews(),
+                                                   swapChain.getDepthImagesSamplers());
+}
+
+void LvePostProcessingManager::createPostPasses() {
+    postPasses.clear();
+    size_t i = 0;
+    while (i < postProcessings.size()) {
+        std::vector<std::string> pixelFunctions;
+        while (i + pixelFunctions.size() < postProcessings.size() &&
+               pixelFunctions.size() < LvePostFusion::MAX_FUSED_EFFECTS) {
+            std::string pixelFunction = postProcessings[i + pixelFunctions.size()]->getPixelFunction();
+            if (pixelFunction.empty()) break;
+            pixelFunctions.push_back(std::move(pixelFunction));
+        }
 
-        LveDescriptorWriter(*LveDescriptorSetLayout::depthTextureSetLayout, *postprocessingPool)
-            .writeImage(0, &depthImageDescriptorInfo)
-            .build(depthDescriptorSets[i]);
+        // un effet par pixel seul garde son propre shader
+        size_t count = std::max<size_t>(pixelFunctions.size(), 1);
+        LveCPipeline *fusedPipeline = count > 1 ? postFusion->getPipeline(pixelFunctions) : nullptr;
+        if (fusedPipeline) {
+            postPasses.push_back({i, count, fusedPipeline});
+        } else {
+            for (size_t j = 0; j < count; j++) {
+                postPasses.push_back({i + j, 1, nullptr});
+            }
+        }
+        i += count;
     }
 }
 
 void LvePostProcessingManager::addPostProcessing(std::shared_ptr<LveIPostProcessing> postProcessing) {
+    postProcessing->resize(windowExtent);
     postProcessings.push_back(postProcessing);
+    createPostPasses();
+}
+
+void LvePostProcessingManager::clearPostProcessings() {
+    postProcessings.clear();
+    postPasses.clear();
 }
 
-void LvePostProcessingManager::clearPostProcessings() { postProcessings.clear(); }
+void LvePostProcessingManager::drawPostProcessings(FrameInfo frameInfo, VkImage sceneImage, VkImage swapChainImage,
+                                                   VkImage depthImage, VkExtent2D renderExtent,
+                                                   LveGpuTimer &gpuTimer, LveFrameSync &frameSync,
+                                                   VkSemaphore acquireSemaphore, VkSemaphore presentSemaphore) {
+    VkCommandBuffer commandBuffer = frameInfo.postProcessingCommandBuffer;
+    gpuTimer.resume(commandBuffer, frameInfo.frameIndex);
+
+    // la frame précédente de ce slot est terminée : sa texture et ses sets ne sont plus lus par le GPU
+    if (outdatedFrames[frameInfo.frameIndex]) {
+        textures[frameInfo.frameIndex]->resizePostprocessingTexture(windowExtent.width, windowExtent.height);
+        writeDescriptorSets(frameInfo.frameIndex);
+        outdatedFrames[frameInfo.frameIndex] = false;
+    }
 
-void LvePostProcessingManager::drawPostProcessings(FrameInfo frameInfo, VkImage swapChainImage, VkImage depthImage,
-                                                   SynchronisationObjects &syncObjects) {
-    copySwapChainImageToTexture(frameInfo, swapChainImage, textures[frameInfo.frameIndex * 2]->getTextureImage());
+    VkImage textureImage = textures[frameInfo.frameIndex]->getTextureImage();
+    size_t setIndex = frameInfo.frameIndex * imageCount + frameInfo.swapChainImageIndex;
+
+    // la scène est déjà dans une image storage, plus de copie depuis la swapchain
+    bool resultInTexture = renderExtent.width != windowExtent.width || renderExtent.height != windowExtent.height;
+    if (resultInTexture) {
+        upscaleSceneImage(frameInfo, sceneImage, textureImage, renderExtent);
+    } else {
+        std::array<VkImageMemoryBarrier, 2> barriers{};
+        barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barriers[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barriers[0].dstAccessMask =
+            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+        barriers[0].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barriers[0].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barriers[0].image = sceneImage;
+        barriers[0].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+        // le contenu de la texture de la frame précédente n'est plus utile
+        barriers[1] = barriers[0];
+        barriers[1].srcAccessMask = 0;
+        barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barriers[1].image = textureImage;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                             nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+    }
 
     VkImageMemoryBarrier transferDestImageBarrier{};
     transferDestImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -124,27 +233,72 @@ void LvePostProcessingManager::drawPostProcessings(FrameInfo frameInfo, VkImage
     transferDestImageBarrier.image = depthImage;
     transferDestImageBarrier.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1};
 
-    vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &transferDestImageBarrier);
 
-    int i;
-    for (i = 0; i < postProcessings.size(); i++) {
-        vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+    // une seule linéarisation par frame, partagée par tous les effets
+    if (!postProcessings.empty()) {
+        linearDepth->build(commandBuffer, frameInfo.swapChainImageIndex, frameInfo.camera.getProjection(),
+                           frameInfo.renderScale);
+    }
+
+    // sortie storage : le dernier effet écrit directement dans l'image de la swapchain, sans copie finale
+    bool storageOutput = outputMode == LvePostOutputStorage && !postProcessings.empty();
+    VkImageMemoryBarrier swapChainImageBarrier{};
+    swapChainImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    swapChainImageBarrier.image = swapChainImage;
+    swapChainImageBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    if (storageOutput) {
+        swapChainImageBarrier.srcAccessMask = 0;
+        swapChainImageBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        swapChainImageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        swapChainImageBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        // même stage que l'attente de l'acquisition : la transition a lieu une fois l'image rendue par la présentation
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                              VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
-                             &imagesBarriers[frameInfo.frameIndex * 2 + (i % 2)]);
+                             &swapChainImageBarrier);
+    }
 
-        postProcessings[i]->executePostCpS(frameInfo, texturesDescriptorSets[frameInfo.frameIndex].first,
-                                           depthDescriptorSets[frameInfo.swapChainImageIndex], windowExtent);
+    VkMemoryBarrier effectBarrier{};
+    effectBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    effectBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    effectBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+    for (size_t i = 0; i < postPasses.size(); i++) {
+        if (i > 0) {
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &effectBarrier, 0, nullptr, 0, nullptr);
+        }
 
-        std::swap(texturesDescriptorSets[frameInfo.frameIndex].first,
-                  texturesDescriptorSets[frameInfo.frameIndex].second);
+        const auto &descriptorSets = storageOutput && i + 1 == postPasses.size() ? outputDescriptorSets[setIndex]
+                                                                                  : texturesDescriptorSets[setIndex];
+        VkDescriptorSet textureDescriptorSet = resultInTexture ? descriptorSets.second : descriptorSets.first;
+        const PostPass &postPass = postPasses[i];
+        if (postPass.fusedPipeline) {
+            std::vector<glm::vec4> parameters;
+            for (size_t j = 0; j < postPass.count; j++) {
+                parameters.push_back(postProcessings[postPass.first + j]->getPixelParameters());
+            }
+            postFusion->dispatch(commandBuffer, *postPass.fusedPipeline, parameters, textureDescriptorSet,
+                                 linearDepth->getDescriptorSet(), windowExtent);
+        } else {
+            postProcessings[postPass.first]->executePostCpS(frameInfo, textureDescriptorSet,
+                                                            linearDepth->getDescriptorSet(), windowExtent);
+        }
+        resultInTexture = !resultInTexture;
     }
-    if (i % 2) {
-        std::swap(texturesDescriptorSets[frameInfo.frameIndex].first,
-                  texturesDescriptorSets[frameInfo.frameIndex].second);
+
+    if (storageOutput) {
+        swapChainImageBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        swapChainImageBarrier.dstAccessMask = 0;
+        swapChainImageBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        swapChainImageBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                             &swapChainImageBarrier);
+    } else {
+        copyToSwapChainImage(frameInfo, swapChainImage, resultInTexture ? textureImage : sceneImage);
     }
-    copyTextureToSwapChainImage(frameInfo, swapChainImage,
-                                textures[frameInfo.frameIndex * 2 + i % 2]->getTextureImage());
 
     transferDestImageBarrier = {};
     transferDestImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -155,180 +309,134 @@ void LvePostProcessingManager::drawPostProcessings(FrameInfo frameInfo, VkImage
     transferDestImageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     transferDestImageBarrier.image = depthImage;
     transferDestImageBarrier.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1};
-    vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                          VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, 0, 0, nullptr, 0, nullptr, 1,
                          &transferDestImageBarrier);
 
-    if (vkEndCommandBuffer(frameInfo.postProcessingCommandBuffer) != VK_SUCCESS) {
+    gpuTimer.end(commandBuffer, frameInfo.frameIndex);
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to record command buffer!");
     }
 
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-
-    VkSemaphore signalSemaphores[] = {computeFinishedSemaphores[frameInfo.frameIndex]};
-
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &frameInfo.postProcessingCommandBuffer;
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSemaphores;
-    submitInfo.waitSemaphoreCount = syncObjects.semaphores.size();
-    submitInfo.pWaitSemaphores = syncObjects.semaphores.data();
-    ;
-    submitInfo.pWaitDstStageMask = waitStages;
-
-    if (vkQueueSubmit(lveDevice.graphicsQueue(), 1, &submitInfo, syncObjects.fences[0]) != VK_SUCCESS) {
-        throw std::runtime_error("failed to submit compute command buffer!");
-    }
-    syncObjects.fences.clear();
-    syncObjects.semaphores.clear();
-    syncObjects.semaphores.push_back(computeFinishedSemaphores[frameInfo.frameIndex]);
+    frameSync.enqueue(LveFrameStagePostProcessing, commandBuffer, acquireSemaphore, presentSemaphore);
 }
 
-void LvePostProcessingManager::createSyncObjects() {
-    computeFinishedSemaphores.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
-    VkSemaphoreCreateInfo semaphoreInfo{};
-    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+void LvePostProcessingManager::upscaleSceneImage(FrameInfo frameInfo, VkImage sceneImage,
+                                                 VkImage postprocessingImage, VkExtent2D renderExtent) {
+    std::array<VkImageMemoryBarrier, 2> barriers{};
+    barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barriers[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[0].image = sceneImage;
+    barriers[0].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    barriers[1] = barriers[0];
+    barriers[1].srcAccessMask = 0;
+    barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barriers[1].image = postprocessingImage;
+
+    vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+                         static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    // résolution dynamique : la zone rendue est agrandie à la taille de la fenêtre avec un filtre bilinéaire
+    VkImageBlit imageBlitRegion{};
+    imageBlitRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    imageBlitRegion.srcSubresource.layerCount = 1;
+    imageBlitRegion.srcOffsets[1] = {static_cast<int32_t>(renderExtent.width),
+                                     static_cast<int32_t>(renderExtent.height), 1};
+    imageBlitRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    imageBlitRegion.dstSubresource.layerCount = 1;
+    imageBlitRegion.dstOffsets[1] = {static_cast<int32_t>(windowExtent.width),
+                                     static_cast<int32_t>(windowExtent.height), 1};
+
+    vkCmdBlitImage(frameInfo.postProcessingCommandBuffer, sceneImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   postprocessingImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlitRegion, VK_FILTER_LINEAR);
+
+    // la scène sert ensuite de seconde image du ping-pong
+    barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[1].dstAccessMask =
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_GENERAL;
 
-    for (size_t i = 0; i < LveSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
-        if (vkCreateSemaphore(lveDevice.device(), &semaphoreInfo, nullptr, &computeFinishedSemaphores[i]) !=
-            VK_SUCCESS) {
-            throw std::runtime_error("failed to create compute synchronization objects for a frame!");
-        }
-    }
+    vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
 }
 
-void LvePostProcessingManager::createImageBarrier() {
-    imagesBarriers.clear();
-    // loop in textures
-    for (auto &texture : textures) {
-        VkImageMemoryBarrier imagesBarrier{};
-        imagesBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        imagesBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
-        imagesBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-        imagesBarrier.image = texture->getTextureImage();
-        imagesBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-        imagesBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
-        imagesBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
-        imagesBarriers.push_back(imagesBarrier);
+void LvePostProcessingManager::copyToSwapChainImage(FrameInfo frameInfo, VkImage swapChainImage,
+                                                    VkImage postprocessingImage) {
+    std::array<VkImageMemoryBarrier, 2> barriers{};
+    barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barriers[0].srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[0].image = postprocessingImage;
+    barriers[0].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    // l'image de la swapchain est entièrement réécrite, son contenu précédent est ignoré
+    barriers[1] = barriers[0];
+    barriers[1].srcAccessMask = 0;
+    barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barriers[1].image = swapChainImage;
+
+    vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT |
+                             VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+                         static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    if (blitOutput) {
+        // la swapchain n'a pas le format de la scène : le blit convertit, à taille égale
+        VkImageBlit blitRegion{};
+        blitRegion.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        blitRegion.srcOffsets[1] = {static_cast<int32_t>(windowExtent.width),
+                                    static_cast<int32_t>(windowExtent.height), 1};
+        blitRegion.dstSubresource = blitRegion.srcSubresource;
+        blitRegion.dstOffsets[1] = blitRegion.srcOffsets[1];
+        vkCmdBlitImage(frameInfo.postProcessingCommandBuffer, postprocessingImage,
+                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapChainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                       &blitRegion, VK_FILTER_NEAREST);
+    } else {
+        // même format des deux côtés : copie brute, sans conversion
+        VkImageCopy imageCopyRegion{};
+        imageCopyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageCopyRegion.srcSubresource.layerCount = 1;
+        imageCopyRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageCopyRegion.dstSubresource.layerCount = 1;
+        imageCopyRegion.extent.width = windowExtent.width;
+        imageCopyRegion.extent.height = windowExtent.height;
+        imageCopyRegion.extent.depth = 1;
+
+        vkCmdCopyImage(frameInfo.postProcessingCommandBuffer, postprocessingImage,
+                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapChainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                       &imageCopyRegion);
     }
-}
-
-void LvePostProcessingManager::copySwapChainImageToTexture(FrameInfo frameInfo, VkImage swapChainImage,
-                                                           VkImage postprocessingImage) {
-    VkImageMemoryBarrier transferDestImageBarrier{};
-    transferDestImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    transferDestImageBarrier.srcAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
-    transferDestImageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    transferDestImageBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
-    transferDestImageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    transferDestImageBarrier.image = postprocessingImage;
-    transferDestImageBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-
-    VkImageMemoryBarrier transferSwapChainImageBarrier{};
-    transferSwapChainImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    transferSwapChainImageBarrier.srcAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-    transferSwapChainImageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    transferSwapChainImageBarrier.oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-    transferSwapChainImageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    transferSwapChainImageBarrier.image = swapChainImage;
-    transferSwapChainImageBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-
-    vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &transferDestImageBarrier);
-    vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &transferSwapChainImageBarrier);
-
-    VkImageCopy imageCopyRegion{};
-    imageCopyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    imageCopyRegion.srcSubresource.layerCount = 1;
-    imageCopyRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    imageCopyRegion.dstSubresource.layerCount = 1;
-    imageCopyRegion.extent.width = windowExtent.width;
-    imageCopyRegion.extent.height = windowExtent.height;
-    imageCopyRegion.extent.depth = 1;
-
-    // Issue the copy command
-    vkCmdCopyImage(frameInfo.postProcessingCommandBuffer, swapChainImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                   postprocessingImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopyRegion);
-
-    VkImageMemoryBarrier transferBackDestImageBarrier{};
-    transferBackDestImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    transferBackDestImageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    transferBackDestImageBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
-    transferBackDestImageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    transferBackDestImageBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-    transferBackDestImageBarrier.image = postprocessingImage;
-    transferBackDestImageBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-
-    vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
-                         &transferBackDestImageBarrier);
-}
 
-void LvePostProcessingManager::copyTextureToSwapChainImage(FrameInfo frameInfo, VkImage swapChainImage,
-                                                           VkImage postprocessingImage) {
-    VkImageMemoryBarrier transferDestImageBarrier{};
-    transferDestImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    transferDestImageBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
-    transferDestImageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    transferDestImageBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
-    transferDestImageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    transferDestImageBarrier.image = postprocessingImage;
-    transferDestImageBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-
-    VkImageMemoryBarrier transferSwapChainImageBarrier{};
-    transferSwapChainImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    transferSwapChainImageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    transferSwapChainImageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    transferSwapChainImageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    transferSwapChainImageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    transferSwapChainImageBarrier.image = swapChainImage;
-    transferSwapChainImageBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-
-    vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &transferDestImageBarrier);
-    vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &transferSwapChainImageBarrier);
-
-    VkImageCopy imageCopyRegion{};
-    imageCopyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    imageCopyRegion.srcSubresource.layerCount = 1;
-    imageCopyRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    imageCopyRegion.dstSubresource.layerCount = 1;
-    imageCopyRegion.extent.width = windowExtent.width;
-    imageCopyRegion.extent.height = windowExtent.height;
-    imageCopyRegion.extent.depth = 1;
-
-    // Issue the copy command
-    vkCmdCopyImage(frameInfo.postProcessingCommandBuffer, postprocessingImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                   swapChainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopyRegion);
-
-    VkImageMemoryBarrier transferBackDestImageBarrier{};
-    transferBackDestImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    transferBackDestImageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    transferBackDestImageBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
-    transferBackDestImageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    transferBackDestImageBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-    transferBackDestImageBarrier.image = postprocessingImage;
-    transferBackDestImageBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-
-    VkImageMemoryBarrier transferBackSwapchainImageBarrier{};
-    transferBackSwapchainImageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    transferBackSwapchainImageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    transferBackSwapchainImageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-    transferBackSwapchainImageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    transferBackSwapchainImageBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-    transferBackSwapchainImageBarrier.image = swapChainImage;
-    transferBackSwapchainImageBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    VkImageMemoryBarrier presentBarrier{};
+    presentBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    presentBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    presentBarrier.dstAccessMask = 0;
+    presentBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    presentBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    presentBarrier.image = swapChainImage;
+    presentBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
 
     vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
-                         &transferBackDestImageBarrier);
-    vkCmdPipelineBarrier(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
-                         &transferBackSwapchainImageBarrier);
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &presentBarrier);
 }
 
-}  // namespace lve
\ No newline at end of file
+}  // namespace lve
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "lve_device.hpp"
+#include "lve_frame_sync.hpp"
+#include "lve_gpu_timer.hpp"
+#include "lve_linear_depth.hpp"
+#include "lve_post_fusion.hpp"
+#include "lve_swap_chain.hpp"
 #include "lve_texture.hpp"
 #include "systems/lve_Ipost_processing.hpp"
 #include "lve_frame_info.hpp"
@@ -15,41 +20,73 @@ namespace lve
   class LvePostProcessingManager
   {
   public:
-    LvePostProcessingManager(LveDevice &deviceRef, VkExtent2D windowExtent, std::vector<VkImageView> depthImageViews, std::vector<VkSampler> depthSamplers);
-    LvePostProcessingManager(VkExtent2D windowExtent,LvePostProcessingManager &postProcessingManager, std::vector<VkImageView> depthImageViews, std::vector<VkSampler> depthSamplers);
+    LvePostProcessingManager(LveDevice &deviceRef, LveSwapChain &swapChain);
     ~LvePostProcessingManager();
-    
-    void createTexture();
+
+    // nouvelle swapchain après un redimensionnement ou un changement de sortie, sans attendre le GPU : les textures
+    // et les sets de chaque frame sont mis à jour en place au début de sa prochaine utilisation, une fois sa frame
+    // précédente terminée
+    void resize(LveSwapChain &swapChain);
+
+    void createTexture(VkFormat textureFormat);
     void createDescriptorPool();
-    void createDescriptorSet(std::vector<VkImageView> depthImageViews, std::vector<VkSampler> depthSamplers);
-    void createSyncObjects();
-    void createImageBarrier();
+    void allocateDescriptorSets();
+    // réécrit en place les sets de la frame, ses images ne doivent plus être utilisées par le GPU
+    void writeDescriptorSets(int frame);
+    void createLinearDepth(LveSwapChain &swapChain);
+    // regroupe les effets par pixel consécutifs, les shaders fusionnés sont compilés ici et pas pendant la frame
+    void createPostPasses();
 
     void addPostProcessing(std::shared_ptr<LveIPostProcessing> postProcessing);
-    
-    void clearPostProcessings();
 
-    void drawPostProcessings(FrameInfo frameInfo, VkImage swapChainImage, VkImage depthImage, SynchronisationObjects &syncObjects);
-
-    void copySwapChainImageToTexture(FrameInfo frameInfo, VkImage swapChainImage, VkImage postprocessingImage);
+    void clearPostProcessings();
 
-    void copyTextureToSwapChainImage(FrameInfo frameInfo, VkImage swapChainImage, VkImage postprocessingImage);
+    // sceneImage : cible de la passe de scène, les effets la lisent et l'écrivent en place avec une texture par frame
+    // renderExtent : zone de sceneImage où la scène a été rendue, agrandie à la taille de la fenêtre avant les effets
+    // acquireSemaphore et presentSemaphore : semaphores binaires de la swapchain pour swapChainImage
+    void drawPostProcessings(FrameInfo frameInfo, VkImage sceneImage, VkImage swapChainImage, VkImage depthImage,
+                             VkExtent2D renderExtent, LveGpuTimer &gpuTimer, LveFrameSync &frameSync,
+                             VkSemaphore acquireSemaphore, VkSemaphore presentSemaphore);
 
-    VkSemaphore getComputeSemaphore(int frame_index) const {return computeFinishedSemaphores[frame_index];};
+    void upscaleSceneImage(FrameInfo frameInfo, VkImage sceneImage, VkImage postprocessingImage,
+                           VkExtent2D renderExtent);
 
+    void copyToSwapChainImage(FrameInfo frameInfo, VkImage swapChainImage, VkImage postprocessingImage);
 
+    // LvePostOutputStorage seulement si la swapchain a été créée avec l'usage storage
+    LvePostOutputMode getOutputMode() const {return outputMode;};
 
   private:
     LveDevice &lveDevice;
 
     VkExtent2D windowExtent;
+    size_t imageCount;
+    LvePostOutputMode outputMode;
+    // la swapchain n'a pas le format de la scène, voir LveSwapChain::needsOutputBlit
+    bool blitOutput;
     std::unique_ptr<LveDescriptorPool> postprocessingPool;
+    // une texture de travail par frame en vol, la seconde image du ping-pong est la cible de scène
     std::vector<std::unique_ptr<LveTexture>> textures;
+    // frames dont la texture et les sets n'ont pas encore suivi le dernier redimensionnement
+    std::vector<bool> outdatedFrames;
+    std::vector<VkImageView> sceneViews;
+    std::vector<VkImageView> swapChainViews;
+    // par frame et image de swapchain : {scène -> texture, texture -> scène}
     std::vector<std::pair<VkDescriptorSet, VkDescriptorSet>> texturesDescriptorSets;
+    // par frame et image de swapchain : {scène -> swapchain, texture -> swapchain}, pour le dernier effet
+    std::vector<std::pair<VkDescriptorSet, VkDescriptorSet>> outputDescriptorSets;
     std::vector<std::shared_ptr<LveIPostProcessing>> postProcessings;
-    std::vector<VkImageMemoryBarrier> imagesBarriers;
-    std::vector<VkSemaphore> computeFinishedSemaphores;
-    std::vector<VkDescriptorSet> depthDescriptorSets;
-    
+    // effets consécutifs exécutés par un même dispatch, fusedPipeline nul pour un effet exécuté seul
+    struct PostPass
+    {
+      size_t first;
+      size_t count;
+      LveCPipeline *fusedPipeline;
+    };
+    std::vector<PostPass> postPasses;
+    std::unique_ptr<LvePostFusion> postFusion;
+    // construite au début des effets, passée à chacun comme set de profondeur
+    std::unique_ptr<LveLinearDepth> linearDepth;
+
   };
-}
\ No newline at end of file
+}
@@ -0,0 +1,96 @@
+#include "lve_render_queue.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace lve {
+
+// une profondeur positive a des bits ordonnés comme sa valeur
+static uint32_t depthBits(float viewDepth) {
+    viewDepth = std::max(viewDepth, 0.f);
+    uint32_t bits;
+    std::memcpy(&bits, &viewDepth, sizeof(bits));
+    return bits;
+}
+
+uint64_t LveRenderQueue::makeOpaqueKey(RenderLayer layer, uint16_t pipelineId, uint16_t materialId, float viewDepth) {
+    assert(layer != RenderLayerTransparent && "Transparent packets must use makeTransparentKey");
+    return (static_cast<uint64_t>(layer) << 60) | (static_cast<uint64_t>(pipelineId & 0xFFF) << 48) |
+           (static_cast<uint64_t>(materialId) << 32) | depthBits(viewDepth);
+}
+
+uint64_t LveRenderQueue::makeTransparentKey(uint16_t pipelineId, uint16_t materialId, float viewDepth) {
+    return (static_cast<uint64_t>(RenderLayerTransparent) << 60) |
+           (static_cast<uint64_t>(~depthBits(viewDepth)) << 28) | (static_cast<uint64_t>(pipelineId & 0xFFF) << 16) |
+           materialId;
+}
+
+uint16_t LveRenderQueue::getPipelineId(const LveGPipeline *pipeline) {
+    auto it = pipelineIds.find(pipeline);
+    if (it == pipelineIds.end()) {
+        assert(pipelineIds.size() < 0xFFF && "Too many pipelines for the sort key");
+        it = pipelineIds.emplace(pipeline, static_cast<uint16_t>(pipelineIds.size())).first;
+    }
+    return it->second;
+}
+
+void LveRenderQueue::sort() {
+    order.resize(packets.size());
+    for (uint32_t i = 0; i < packets.size(); i++) {
+        order[i] = {packets[i].sortKey, i};
+    }
+    std::sort(order.begin(), order.end());
+}
+
+void LveRenderQueue::record(VkCommandBuffer commandBuffer, size_t begin, size_t end) {
+    assert(order.size() == packets.size() && "Render queue must be sorted before recording");
+
+    LveGPipeline *boundPipeline = nullptr;
+    VkPipelineLayout boundLayout = VK_NULL_HANDLE;
+    std::array<VkDescriptorSet, 6> boundSets{};
+    uint32_t boundSetCount = 0;
+    LveModel *boundModel = nullptr;
+
+    for (size_t i = begin; i < end; i++) {
+        DrawPacket &packet = packets[order[i].second];
+
+        if (packet.pipeline != boundPipeline) {
+            packet.pipeline->bind(commandBuffer);
+            boundPipeline = packet.pipeline;
+        }
+        // les sets liés avec un autre layout ne sont pas forcément compatibles
+        if (packet.pipelineLayout != boundLayout) {
+            boundLayout = packet.pipelineLayout;
+            boundSetCount = 0;
+        }
+
+        // seuls les sets à partir du premier qui diffère sont reliés
+        uint32_t firstSet = 0;
+        while (firstSet < packet.descriptorSetCount && firstSet < boundSetCount &&
+               boundSets[firstSet] == packet.descriptorSets[firstSet]) {
+            firstSet++;
+        }
+        if (firstSet < packet.descriptorSetCount) {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, packet.pipelineLayout, firstSet,
+                                    packet.descriptorSetCount - firstSet, &packet.descriptorSets[firstSet], 0,
+                                    nullptr);
+            std::copy(packet.descriptorSets.begin() + firstSet,
+                      packet.descriptorSets.begin() + packet.descriptorSetCount, boundSets.begin() + firstSet);
+            boundSetCount = std::max(boundSetCount, packet.descriptorSetCount);
+        }
+
+        if (packet.model != nullptr && packet.model != boundModel) {
+            packet.model->bind(commandBuffer);
+            boundModel = packet.model;
+        }
+
+        packet.draw(commandBuffer);
+        // un paquet sans modèle peut lier ses propres buffers dans draw
+        if (packet.model == nullptr) {
+            boundModel = nullptr;
+        }
+    }
+}
+
+}  // namespace lve
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lve_g_pipeline.hpp"
+#include "lve_model.hpp"
+
+namespace lve {
+
+// premier critère de tri dans une render pass
+enum RenderLayer {
+    RenderLayerOpaque = 0,       // du plus proche au plus loin, pour l'early-Z
+    RenderLayerBackground = 1,   // plein écran au fond (océan lointain), après les opaques
+    RenderLayerTransparent = 2,  // du plus loin au plus proche, pour le blending
+};
+
+struct DrawPacket {
+    uint64_t sortKey;
+    LveGPipeline *pipeline;
+    VkPipelineLayout pipelineLayout;
+    // liés à partir du set 0, sans trou
+    uint32_t descriptorSetCount = 0;
+    std::array<VkDescriptorSet, 6> descriptorSets{};
+    // vertex/index buffers, nullptr pour les pipelines sans vertex input ou qui les lient dans draw
+    LveModel *model = nullptr;
+    // push constants et commandes de dessin, le reste de l'état est déjà lié
+    std::function<void(VkCommandBuffer)> draw;
+};
+
+/**
+ * File de dessin d'une render pass : les systèmes y soumettent des DrawPacket avec une clé de tri 64 bits (couche,
+ * pipeline, matériau, profondeur). La file est triée puis enregistrée en ne liant pipeline, descriptor sets et
+ * vertex buffers que lorsqu'ils changent d'un paquet à l'autre.
+ */
+class LveRenderQueue {
+   public:
+    // en dessous, découper la file entre plusieurs threads d'enregistrement ne vaut pas les changements d'état
+    static constexpr size_t MIN_PACKETS_PER_CHUNK = 32;
+
+    // opaques : couche | pipeline | matériau | profondeur croissante
+    static uint64_t makeOpaqueKey(RenderLayer layer, uint16_t pipelineId, uint16_t materialId, float viewDepth);
+    // transparents : couche | profondeur décroissante | pipeline | matériau
+    static uint64_t makeTransparentKey(uint16_t pipelineId, uint16_t materialId, float viewDepth);
+
+    // identifiant compact et stable d'un pipeline pour les clés, attribué au premier appel
+    uint16_t getPipelineId(const LveGPipeline *pipeline);
+
+    void clear() { packets.clear(); }
+    void submit(DrawPacket packet) { packets.push_back(std::move(packet)); }
+    void sort();
+
+    // enregistre les paquets triés [begin, end), l'état lié ne survit pas d'un appel à l'autre
+    void record(VkCommandBuffer commandBuffer, size_t begin, size_t end);
+
+    size_t size() const { return packets.size(); }
+    bool empty() const { return packets.empty(); }
+
+   private:
+    std::vector<DrawPacket> packets;
+    // (clé, index de soumission) : l'index départage les clés égales, le tri reste déterministe
+    std::vector<std::pair<uint64_t, uint32_t>> order;
+    std::unordered_map<const LveGPipeline *, uint16_t> pipelineIds;
+};
+}  // namespace lve
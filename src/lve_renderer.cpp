@@ -3,11 +3,13 @@
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
 #include <array>
 #include <glm/fwd.hpp>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <thread>
 
 #include "lve_device.hpp"
 #include "lve_swap_chain.hpp"
@@ -17,7 +19,15 @@
 
 namespace lve {
 
-LveRenderer::LveRenderer(LveWindow &window, LveDevice &device) : lveWindow{window}, lveDevice{device} {
+LveRenderer::LveRenderer(LveWindow &window, LveDevice &device, LvePostOutputMode postOutputMode, int framesInFlight,
+                         VkPresentModeKHR presentMode)
+    : lveWindow{window},
+      lveDevice{device},
+      requestedPostOutputMode{postOutputMode},
+      requestedPresentMode{presentMode} {
+    // avant toute ressource par frame, celles des systèmes sont créées après le renderer
+    LveSwapChain::setFramesInFlight(framesInFlight);
+
     std::shared_ptr<LveDescriptorSetLayout::Builder> setLayoutBuilder =
         std::make_shared<LveDescriptorSetLayout::Builder>(lveDevice);
     setLayoutBuilder->addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT);
@@ -26,12 +36,18 @@ LveRenderer::LveRenderer(LveWindow &window, LveDevice &device) : lveWindow{windo
 
     setLayoutBuilder = std::make_shared<LveDescriptorSetLayout::Builder>(lveDevice);
     setLayoutBuilder->addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT);
-    LveDescriptorSetLayout::depthTextureSetLayout = setLayoutBuilder->build();
+    LveDescriptorSetLayout::linearDepthSetLayout = setLayoutBuilder->build();
 
+    hiZPyramid = std::make_unique<LveHiZPyramid>(lveDevice);
+    frameSync = std::make_unique<LveFrameSync>(lveDevice);
     recreateSwapChain();
 
     preProcessingManager = std::make_unique<LvePreProcessingManager>(lveDevice);
     createCommandBuffers();
+
+    uint32_t threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, MAX_RECORDING_THREADS);
+    parallelRecorder = std::make_unique<LveParallelRecorder>(lveDevice, threadCount);
+    gpuTimer = std::make_unique<LveGpuTimer>(lveDevice);
 }
 LveRenderer::~LveRenderer() { freeCommandBuffers(); }
 
@@ -42,29 +58,33 @@ void LveRenderer::recreateSwapChain() {
         glfwWaitEvents();
     }
 
-    vkDeviceWaitIdle(lveDevice.device());
-
     if (lveSwapChain == nullptr) {
-        lveSwapChain = std::make_unique<LveSwapChain>(lveDevice, extent);
+        lveSwapChain = std::make_unique<LveSwapChain>(
+            lveDevice, extent, requestedPostOutputMode == LvePostOutputStorage, requestedPresentMode);
 
-        postProcessingManager = std::make_unique<LvePostProcessingManager>(
-            lveDevice, extent, lveSwapChain->getDepthImageViews(), lveSwapChain->getDepthImagesSamplers());
+        postProcessingManager = std::make_unique<LvePostProcessingManager>(lveDevice, *lveSwapChain);
 
     } else {
         std::shared_ptr<LveSwapChain> oldSwapChain = std::move(lveSwapChain);
-        lveSwapChain = std::make_unique<LveSwapChain>(lveDevice, extent, oldSwapChain);
+        lveSwapChain = std::make_unique<LveSwapChain>(
+            lveDevice, extent, oldSwapChain, requestedPostOutputMode == LvePostOutputStorage, requestedPresentMode);
 
         if (!oldSwapChain->compareSwapFormats(*lveSwapChain.get())) {
             throw std::runtime_error("Swap chain image(or depth) format has changed!");
         }
-        postProcessingManager = std::make_unique<LvePostProcessingManager>(extent, (*postProcessingManager),
-                                                                           lveSwapChain->getDepthImageViews(),
-                                                                           lveSwapChain->getDepthImagesSamplers());
+        // sans vkDeviceWaitIdle : images, vues et framebuffers de l'ancienne swapchain restent lus par les frames en
+        // vol, elle n'est détruite qu'une fois celles-ci terminées
+        lveDevice.retire([oldSwapChain]() {});
+        postProcessingManager->resize(*lveSwapChain);
     }
+
+    hiZPyramid->resize(lveSwapChain->getSwapChainExtent(), lveSwapChain->getDepthImageViews(),
+                       lveSwapChain->getDepthImagesSamplers());
+    imagesInFlight.assign(lveSwapChain->imageCount(), 0);
 }
 
 void LveRenderer::createCommandBuffers() {
-    commandBuffers.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+    commandBuffers.resize(LveSwapChain::getFramesInFlight());
 
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -76,7 +96,7 @@ void LveRenderer::createCommandBuffers() {
         throw std::runtime_error("failed to allocate commande buffers!");
     }
 
-    preProcessingBuffers.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+    preProcessingBuffers.resize(LveSwapChain::getFramesInFlight());
 
     allocInfo = {};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -88,7 +108,7 @@ void LveRenderer::createCommandBuffers() {
         throw std::runtime_error("failed to allocate commande buffers!");
     }
 
-    postProcessingBuffers.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+    postProcessingBuffers.resize(LveSwapChain::getFramesInFlight());
 
     allocInfo = {};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -115,9 +135,14 @@ void LveRenderer::freeCommandBuffers() {
     postProcessingBuffers.clear();
 }
 
-bool LveRenderer::startRendering(SynchronisationObjects &syncObjects) {
+bool LveRenderer::startRendering() {
     assert(!isFrameStarted && "Can't call beginFrame while already in progress");
-    auto result = lveSwapChain->acquireNextImage(&currentImageIndex, syncObjects);
+    // la frame qui a utilisé ce slot getFramesInFlight() frames plus tôt doit être terminée
+    uint64_t framesInFlight = static_cast<uint64_t>(LveSwapChain::getFramesInFlight());
+    if (frameNumber >= framesInFlight) {
+        frameSync->waitForFrame(frameNumber - framesInFlight);
+    }
+    auto result = lveSwapChain->acquireNextImage(&currentImageIndex);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
         recreateSwapChain();
@@ -127,12 +152,26 @@ bool LveRenderer::startRendering(SynchronisationObjects &syncObjects) {
     if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
         throw std::runtime_error("failed to acquire swap chain image!");
     }
+
+    // cibles de scène et de profondeur de cette image, encore utilisées si une frame d'un autre slot l'a acquise
+    if (imagesInFlight[currentImageIndex] > 0) {
+        frameSync->waitForFrame(imagesInFlight[currentImageIndex] - 1);
+    }
+    imagesInFlight[currentImageIndex] = frameNumber + 1;
+
+    frameSync->beginFrame(frameNumber);
+    lveDevice.beginFrame(frameNumber, frameSync->getCompletedFrames());
+    frameNumber++;
+
     isFrameStarted = true;
     return true;
 }
 
-VkCommandBuffer LveRenderer::beginFrame(SynchronisationObjects &syncObjects) {
+VkCommandBuffer LveRenderer::beginFrame() {
     auto commandBuffer = getCurrentCommandBuffer();
+    parallelRecorder->beginFrame(currentFrameIndex);
+    // la frame précédente de ce slot a été attendue par startRendering, ses timestamps sont prêts
+    gpuTimeAvailable = gpuTimer->collect(currentFrameIndex, lastGpuTimeMs);
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
@@ -141,31 +180,54 @@ VkCommandBuffer LveRenderer::beginFrame(SynchronisationObjects &syncObjects) {
     return commandBuffer;
 }
 
-void LveRenderer::endFrame(SynchronisationObjects &syncObjects) {
+void LveRenderer::endFrame() {
     assert(isFrameStarted && "Can't call endFrame while frame is not in progress");
     auto commandBuffer = getCurrentCommandBuffer();
+    gpuTimer->pause(commandBuffer, currentFrameIndex);
     if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to record command buffer!");
     }
-    auto result = lveSwapChain->submitCommandBuffers(&commandBuffer, &currentImageIndex, syncObjects);
+    frameSync->enqueue(LveFrameStageRender, commandBuffer);
 }
 
-void LveRenderer::presentFrame(SynchronisationObjects &syncObjects) {
-    // VkSemaphore postProssessingSemaphore = postProcessingManager->getComputeSemaphore(currentFrameIndex);
-    VkSemaphore postProssessingSemaphore = postProcessingManager->getComputeSemaphore(currentFrameIndex);
-    auto result = lveSwapChain->presentImage(&currentImageIndex, syncObjects);
-    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || lveWindow.wasWindowResized()) {
+void LveRenderer::presentFrame() {
+    // pre-processing, scène et post-processing de la frame en une seule soumission
+    frameSync->flush();
+    auto result = lveSwapChain->presentImage(&currentImageIndex);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || lveWindow.wasWindowResized() ||
+        swapChainSettingsChanged) {
         lveWindow.resetWindowResizedFlag();
+        swapChainSettingsChanged = false;
         recreateSwapChain();
     } else if (result != VK_SUCCESS) {
         throw std::runtime_error("failed to present swap chain image!");
     }
 
     isFrameStarted = false;
-    currentFrameIndex = (currentFrameIndex + 1) % LveSwapChain::MAX_FRAMES_IN_FLIGHT;
+    currentFrameIndex = (currentFrameIndex + 1) % LveSwapChain::getFramesInFlight();
+}
+
+VkExtent2D LveRenderer::getRenderExtent() const {
+    VkExtent2D extent = lveSwapChain->getSwapChainExtent();
+    return {std::max(static_cast<uint32_t>(extent.width * renderScale), 1u),
+            std::max(static_cast<uint32_t>(extent.height * renderScale), 1u)};
 }
 
-void LveRenderer::beginSwapChainRenderPass(VkCommandBuffer commandBuffer) {
+void LveRenderer::setViewportAndScissor(VkCommandBuffer commandBuffer) {
+    VkExtent2D renderExtent = getRenderExtent();
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(renderExtent.width);
+    viewport.height = static_cast<float>(renderExtent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    VkRect2D scissor{{0, 0}, renderExtent};
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+void LveRenderer::beginSwapChainRenderPass(VkCommandBuffer commandBuffer, VkSubpassContents contents) {
     assert(isFrameStarted && "Can't call beginSwapChainRenderPass while frame is not in progress");
     assert(commandBuffer == getCurrentCommandBuffer() &&
            "Can't beging render pass on command buffer from a different frame");
@@ -175,7 +237,7 @@ void LveRenderer::beginSwapChainRenderPass(VkCommandBuffer commandBuffer) {
     renderPassInfo.framebuffer = lveSwapChain->getFrameBuffer(currentImageIndex);
 
     renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = lveSwapChain->getSwapChainExtent();
+    renderPassInfo.renderArea.extent = getRenderExtent();
 
     std::array<VkClearValue, 2> clearValues{};
     clearValues[0].color = {0.20f, 0.50f, 0.70f, 1.0f};
@@ -183,19 +245,79 @@ void LveRenderer::beginSwapChainRenderPass(VkCommandBuffer commandBuffer) {
     renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
     renderPassInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, contents);
 
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(lveSwapChain->getSwapChainExtent().width);
-    viewport.height = static_cast<float>(lveSwapChain->getSwapChainExtent().height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    VkRect2D scissor{{0, 0}, lveSwapChain->getSwapChainExtent()};
-    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    // le viewport n'est pas hérité par les secondary command buffers, ils le fixent eux-mêmes
+    if (contents == VK_SUBPASS_CONTENTS_INLINE) {
+        setViewportAndScissor(commandBuffer);
+    }
+}
+
+void LveRenderer::resumeSwapChainRenderPass(VkCommandBuffer commandBuffer, VkSubpassContents contents) {
+    assert(isFrameStarted && "Can't call resumeSwapChainRenderPass while frame is not in progress");
+    assert(commandBuffer == getCurrentCommandBuffer() &&
+           "Can't resume render pass on command buffer from a different frame");
+    VkRenderPassBeginInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = lveSwapChain->getLoadRenderPass();
+    renderPassInfo.framebuffer = lveSwapChain->getFrameBuffer(currentImageIndex);
+
+    renderPassInfo.renderArea.offset = {0, 0};
+    renderPassInfo.renderArea.extent = getRenderExtent();
+
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, contents);
+
+    // le viewport n'est pas hérité par les secondary command buffers, ils le fixent eux-mêmes
+    if (contents == VK_SUBPASS_CONTENTS_INLINE) {
+        setViewportAndScissor(commandBuffer);
+    }
+}
+
+void LveRenderer::recordRenderSystems(FrameInfo &frameInfo, const std::vector<RenderFunction> &renderFunctions) {
+    assert(isFrameStarted && "Can't call recordRenderSystems while frame is not in progress");
+
+    // les deux render pass de la swapchain sont compatibles, les secondary buffers peuvent servir dans l'une ou l'autre
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = lveSwapChain->getRenderPass();
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = lveSwapChain->getFrameBuffer(currentImageIndex);
+
+    std::vector<LveParallelRecorder::Recorder> recorders;
+    recorders.reserve(renderFunctions.size());
+    for (const auto &renderFunction : renderFunctions) {
+        recorders.push_back([this, &frameInfo, &renderFunction](VkCommandBuffer commandBuffer) {
+            setViewportAndScissor(commandBuffer);
+            FrameInfo threadFrameInfo = frameInfo;
+            threadFrameInfo.commandBuffer = commandBuffer;
+            renderFunction(threadFrameInfo);
+        });
+    }
+
+    std::vector<VkCommandBuffer> secondaryCommandBuffers = parallelRecorder->record(inheritanceInfo, recorders);
+    vkCmdExecuteCommands(frameInfo.commandBuffer, static_cast<uint32_t>(secondaryCommandBuffers.size()),
+                         secondaryCommandBuffers.data());
 }
+
+void LveRenderer::recordRenderQueue(FrameInfo &frameInfo, LveRenderQueue &renderQueue) {
+    if (renderQueue.empty()) return;
+    renderQueue.sort();
+
+    // chaque tranche relie son état au début : on ne découpe que les files assez longues
+    size_t chunkCount = std::clamp<size_t>(renderQueue.size() / LveRenderQueue::MIN_PACKETS_PER_CHUNK, 1,
+                                           parallelRecorder->getThreadCount());
+    std::vector<RenderFunction> renderFunctions;
+    renderFunctions.reserve(chunkCount);
+    for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+        size_t begin = renderQueue.size() * chunk / chunkCount;
+        size_t end = renderQueue.size() * (chunk + 1) / chunkCount;
+        renderFunctions.push_back([&renderQueue, begin, end](FrameInfo &info) {
+            renderQueue.record(info.commandBuffer, begin, end);
+        });
+    }
+    recordRenderSystems(frameInfo, renderFunctions);
+}
+
 void LveRenderer::endSwapChainRenderPass(VkCommandBuffer commandBuffer) {
     assert(isFrameStarted && "Can't call endSwapChainRenderPass while frame is not in progress");
     assert(commandBuffer == getCurrentCommandBuffer() &&
@@ -203,7 +325,14 @@ void LveRenderer::endSwapChainRenderPass(VkCommandBuffer commandBuffer) {
     vkCmdEndRenderPass(commandBuffer);
 }
 
-void LveRenderer::renderPostProssessingEffects(FrameInfo frameInfo, SynchronisationObjects &syncObjects) {
+void LveRenderer::buildDepthPyramid(VkCommandBuffer commandBuffer) {
+    assert(isFrameStarted && "Can't call buildDepthPyramid while frame is not in progress");
+    hiZPyramid->build(commandBuffer, lveSwapChain->getActualDepthImages(currentImageIndex), currentImageIndex,
+                      getRenderExtent());
+}
+
+void LveRenderer::renderPostProssessingEffects(FrameInfo frameInfo) {
+    VkImage sceneImage = lveSwapChain->getSceneColorImage(currentImageIndex);
     VkImage swapchainImage = lveSwapChain->getActualswapChainImages(currentImageIndex);
     VkImage depthImage = lveSwapChain->getActualDepthImages(currentImageIndex);
     VkCommandBufferBeginInfo beginInfo{};
@@ -212,21 +341,24 @@ void LveRenderer::renderPostProssessingEffects(FrameInfo frameInfo, Synchronisat
         throw std::runtime_error("failed to begin recording command buffer!");
     }
 
-    postProcessingManager->drawPostProcessings(frameInfo, swapchainImage, depthImage, syncObjects);
+    postProcessingManager->drawPostProcessings(frameInfo, sceneImage, swapchainImage, depthImage, getRenderExtent(),
+                                               *gpuTimer, *frameSync, lveSwapChain->getImageAvailableSemaphore(),
+                                               lveSwapChain->getRenderFinishedSemaphore());
 }
 
 void LveRenderer::addPostProcessingEffect(std::shared_ptr<LveIPostProcessing> postProcessing) {
     postProcessingManager->addPostProcessing(postProcessing);
 }
 
-void LveRenderer::executePreProssessingEffects(FrameInfo frameInfo, SynchronisationObjects &syncObjects) {
+void LveRenderer::executePreProssessingEffects(FrameInfo frameInfo) {
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     if (vkBeginCommandBuffer(frameInfo.preProcessingCommandBuffer, &beginInfo) != VK_SUCCESS) {
         throw std::runtime_error("failed to begin recording command buffer!");
     }
+    gpuTimer->begin(frameInfo.preProcessingCommandBuffer, currentFrameIndex);
 
-    preProcessingManager->executePreprocessing(frameInfo, syncObjects);
+    preProcessingManager->executePreprocessing(frameInfo, *frameSync);
 }
 
 void LveRenderer::addPreProcessingEffect(std::shared_ptr<LveIPreProcessing> preProcessing) {
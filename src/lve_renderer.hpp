@@ -2,11 +2,18 @@
 
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "lve_device.hpp"
+#include "lve_frame_sync.hpp"
+#include "lve_gpu_timer.hpp"
+#include "lve_hiz_pyramid.hpp"
+#include "lve_parallel_recorder.hpp"
 #include "lve_post_processing_manager.hpp"
 #include "lve_pre_processing_manager.hpp"
+#include "lve_render_queue.hpp"
 #include "lve_swap_chain.hpp"
 #include "lve_utils.hpp"
 #include "lve_window.hpp"
@@ -14,13 +21,49 @@
 namespace lve {
 class LveRenderer {
    public:
-    LveRenderer(LveWindow &window, LveDevice &device);
+    static constexpr uint32_t MAX_RECORDING_THREADS = 4;
+
+    using RenderFunction = std::function<void(FrameInfo &)>;
+
+    // postOutputMode : sortie demandée pour le post-processing, LvePostOutputStorage retombe sur la copie si la
+    // swapchain ne supporte pas l'usage storage. framesInFlight : voir LveSwapChain::setFramesInFlight
+    LveRenderer(LveWindow &window, LveDevice &device, LvePostOutputMode postOutputMode = LvePostOutputCopy,
+                int framesInFlight = LveSwapChain::DEFAULT_FRAMES_IN_FLIGHT,
+                VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR);
     ~LveRenderer();
 
     VkRenderPass getSwapChainRenderPass() const { return lveSwapChain->getRenderPass(); }
     float getAspectRatio() const { return lveSwapChain->extentAspectRatio(); }
+    LveHiZPyramid &getHiZPyramid() const { return *hiZPyramid; }
     bool isFrameInProgress() const { return isFrameStarted; }
 
+    // la scène est rendue dans le coin haut gauche de sa cible couleur puis remise à l'échelle en post-processing
+    void setRenderScale(float scale) {
+        assert(!isFrameStarted && "Can't change the render scale while frame is in progress");
+        renderScale = scale;
+    }
+    float getRenderScale() const { return renderScale; }
+    LvePostOutputMode getPostOutputMode() const { return postProcessingManager->getOutputMode(); }
+    // la swapchain est recréée avec cette sortie après la présentation de la frame en cours, pour comparer les deux
+    // chemins en cours d'exécution
+    void setPostOutputMode(LvePostOutputMode postOutputMode) {
+        requestedPostOutputMode = postOutputMode;
+        swapChainSettingsChanged = true;
+    }
+    // la swapchain est recréée avec ce mode après la présentation de la frame en cours, FIFO s'il n'est pas supporté
+    void setPresentMode(VkPresentModeKHR presentMode) {
+        requestedPresentMode = presentMode;
+        swapChainSettingsChanged = true;
+    }
+    VkPresentModeKHR getPresentMode() const { return lveSwapChain->getPresentMode(); }
+    VkExtent2D getRenderExtent() const;
+
+    // dernière mesure de temps GPU, disponible après beginFrame quand le slot de la frame a été mesuré
+    bool getGpuFrameTime(float &gpuTimeMs) const {
+        gpuTimeMs = lastGpuTimeMs;
+        return gpuTimeAvailable;
+    }
+
     VkCommandBuffer getCurrentCommandBuffer() const {
         assert(isFrameStarted && "Cannot get command buffer when frame not in progress");
         return commandBuffers[currentFrameIndex];
@@ -46,14 +89,23 @@ class LveRenderer {
         return currentImageIndex;
     }
 
-    bool startRendering(SynchronisationObjects &syncObjects);
-    VkCommandBuffer beginFrame(SynchronisationObjects &syncObjects);
-    void endFrame(SynchronisationObjects &syncObjects);
-    void presentFrame(SynchronisationObjects &syncObjects);
-    void renderPostProssessingEffects(FrameInfo frameInfo, SynchronisationObjects &syncObjects);
-    void executePreProssessingEffects(FrameInfo frameInfo, SynchronisationObjects &syncObjects);
-    void beginSwapChainRenderPass(VkCommandBuffer commandBuffer);
+    bool startRendering();
+    VkCommandBuffer beginFrame();
+    void endFrame();
+    void presentFrame();
+    void renderPostProssessingEffects(FrameInfo frameInfo);
+    void executePreProssessingEffects(FrameInfo frameInfo);
+    void beginSwapChainRenderPass(VkCommandBuffer commandBuffer,
+                                  VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
+    void resumeSwapChainRenderPass(VkCommandBuffer commandBuffer,
+                                   VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
+    // enregistre chaque fonction dans un secondary command buffer sur un thread de travail puis les exécute dans
+    // l'ordre, la render pass doit avoir été commencée avec VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+    void recordRenderSystems(FrameInfo &frameInfo, const std::vector<RenderFunction> &renderFunctions);
+    // trie la file puis l'enregistre, découpée en tranches contiguës sur les threads de travail
+    void recordRenderQueue(FrameInfo &frameInfo, LveRenderQueue &renderQueue);
     void endSwapChainRenderPass(VkCommandBuffer commandBuffer);
+    void buildDepthPyramid(VkCommandBuffer commandBuffer);
     void addPostProcessingEffect(std::shared_ptr<LveIPostProcessing> postProcessing);
     void addPreProcessingEffect(std::shared_ptr<LveIPreProcessing> preProcessing);
 
@@ -61,18 +113,34 @@ class LveRenderer {
     void createCommandBuffers();
     void freeCommandBuffers();
     void recreateSwapChain();
+    void setViewportAndScissor(VkCommandBuffer commandBuffer);
 
     LveWindow &lveWindow;
     LveDevice &lveDevice;
+    LvePostOutputMode requestedPostOutputMode;
+    VkPresentModeKHR requestedPresentMode;
+    bool swapChainSettingsChanged{false};
     std::unique_ptr<LveSwapChain> lveSwapChain;
     std::unique_ptr<LvePostProcessingManager> postProcessingManager;
     std::unique_ptr<LvePreProcessingManager> preProcessingManager;
+    std::unique_ptr<LveHiZPyramid> hiZPyramid;
+    std::unique_ptr<LveParallelRecorder> parallelRecorder;
+    std::unique_ptr<LveGpuTimer> gpuTimer;
+    std::unique_ptr<LveFrameSync> frameSync;
     std::vector<VkCommandBuffer> commandBuffers;
     std::vector<VkCommandBuffer> preProcessingBuffers;
     std::vector<VkCommandBuffer> postProcessingBuffers;
+    // par image de la swapchain : numéro de la dernière frame qui l'a utilisée + 1, 0 si aucune
+    std::vector<uint64_t> imagesInFlight;
 
     std::uint32_t currentImageIndex;
     int currentFrameIndex{0};
+    // frames commencées depuis le lancement, numérotation de LveFrameSync et de la file de destruction de LveDevice
+    uint64_t frameNumber{0};
     bool isFrameStarted{false};
+
+    float renderScale{1.f};
+    float lastGpuTimeMs{0.f};
+    bool gpuTimeAvailable{false};
 };
 }  // namespace lve
\ No newline at end of file
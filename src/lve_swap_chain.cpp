@@ -16,12 +16,36 @@
 
 namespace lve {
 
-LveSwapChain::LveSwapChain(LveDevice &deviceRef, VkExtent2D extent) : device{deviceRef}, windowExtent{extent} {
+int LveSwapChain::framesInFlight = LveSwapChain::DEFAULT_FRAMES_IN_FLIGHT;
+
+void LveSwapChain::setFramesInFlight(int count) {
+    if (count < MIN_FRAMES_IN_FLIGHT || count > MAX_FRAMES_IN_FLIGHT) {
+        throw std::runtime_error("frames in flight must be between 1 and 4!");
+    }
+    framesInFlight = count;
+}
+
+// les effets voient ces formats sous la vue POST_PROCESSING_STORAGE_FORMAT, même classe de compatibilité
+static bool isPostProcessingCompatibleFormat(VkFormat format) {
+    return format == VK_FORMAT_B8G8R8A8_SRGB || format == VK_FORMAT_B8G8R8A8_UNORM ||
+           format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+LveSwapChain::LveSwapChain(LveDevice &deviceRef, VkExtent2D extent, bool storageOutput, VkPresentModeKHR presentMode)
+    : device{deviceRef},
+      windowExtent{extent},
+      storageOutputRequested{storageOutput},
+      requestedPresentMode{presentMode} {
     init();
 }
 
-LveSwapChain::LveSwapChain(LveDevice &deviceRef, VkExtent2D extent, std::shared_ptr<LveSwapChain> previous)
-    : device{deviceRef}, windowExtent{extent}, oldSwapChain{previous} {
+LveSwapChain::LveSwapChain(LveDevice &deviceRef, VkExtent2D extent, std::shared_ptr<LveSwapChain> previous,
+                           bool storageOutput, VkPresentModeKHR presentMode)
+    : device{deviceRef},
+      windowExtent{extent},
+      oldSwapChain{previous},
+      storageOutputRequested{storageOutput},
+      requestedPresentMode{presentMode} {
     init();
 
     oldSwapChain = nullptr;
@@ -32,6 +56,7 @@ void LveSwapChain::init() {
     createImageViews();
     createRenderPass();
     createDepthResources();
+    createSceneColorResources();
     createFramebuffers();
     createSyncObjects();
 }
@@ -41,6 +66,10 @@ LveSwapChain::~LveSwapChain() {
         vkDestroyImageView(device.device(), imageView, nullptr);
     }
     swapChainImageViews.clear();
+    for (auto imageView : swapChainStorageViews) {
+        vkDestroyImageView(device.device(), imageView, nullptr);
+    }
+    swapChainStorageViews.clear();
 
     if (swapChain != nullptr) {
         vkDestroySwapchainKHR(device.device(), swapChain, nullptr);
@@ -48,84 +77,45 @@ LveSwapChain::~LveSwapChain() {
     }
 
     for (int i = 0; i < depthImages.size(); i++) {
+        vkDestroySampler(device.device(), depthImagesSamplers[i], nullptr);
         vkDestroyImageView(device.device(), depthImageViews[i], nullptr);
         vkDestroyImage(device.device(), depthImages[i], nullptr);
         vkFreeMemory(device.device(), depthImageMemorys[i], nullptr);
     }
 
+    for (int i = 0; i < sceneColorImages.size(); i++) {
+        vkDestroyImageView(device.device(), sceneColorImageViews[i], nullptr);
+        vkDestroyImageView(device.device(), sceneColorStorageViews[i], nullptr);
+        vkDestroyImage(device.device(), sceneColorImages[i], nullptr);
+        vkFreeMemory(device.device(), sceneColorImageMemorys[i], nullptr);
+    }
+
     for (auto framebuffer : swapChainFramebuffers) {
         vkDestroyFramebuffer(device.device(), framebuffer, nullptr);
     }
 
     vkDestroyRenderPass(device.device(), renderPass, nullptr);
+    vkDestroyRenderPass(device.device(), loadRenderPass, nullptr);
 
-    // cleanup synchronization objects
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    // cleanup synchronization objects, vides s'ils ont été repris par la swapchain suivante
+    for (size_t i = 0; i < imageAvailableSemaphores.size(); i++) {
         vkDestroySemaphore(device.device(), (renderFinishedSemaphores)[i], nullptr);
         vkDestroySemaphore(device.device(), imageAvailableSemaphores[i], nullptr);
-        vkDestroyFence(device.device(), inFlightFences[i], nullptr);
     }
 }
 
-VkResult LveSwapChain::acquireNextImage(uint32_t *imageIndex, SynchronisationObjects &syncObjects) {
-    vkWaitForFences(device.device(), 1, &inFlightFences[currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
-
-    VkResult result = vkAcquireNextImageKHR(device.device(), swapChain, std::numeric_limits<uint64_t>::max(),
-                                            imageAvailableSemaphores[currentFrame],  // must be a not signaled
-                                                                                     // semaphore
-                                            VK_NULL_HANDLE, imageIndex);
-    syncObjects.semaphores.clear();
-    syncObjects.fences.clear();
-    syncObjects.semaphores.push_back(imageAvailableSemaphores[currentFrame]);
-
-    return result;
-}
-
-VkResult LveSwapChain::submitCommandBuffers(const VkCommandBuffer *buffers, uint32_t *imageIndex,
-                                            SynchronisationObjects &syncObjects) {
-    if (imagesInFlight[*imageIndex] != VK_NULL_HANDLE) {
-        vkWaitForFences(device.device(), 1, &imagesInFlight[*imageIndex], VK_TRUE, UINT64_MAX);
-    }
-    imagesInFlight[*imageIndex] = inFlightFences[currentFrame];
-
-    VkSubmitInfo submitInfo = {};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-
-    // VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame]};
-
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = syncObjects.semaphores.data();
-    submitInfo.pWaitDstStageMask = waitStages;
-
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = buffers;
-
-    VkSemaphore signalSemaphores[] = {(renderFinishedSemaphores)[currentFrame]};
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSemaphores;
-
-    vkResetFences(device.device(), 1, &inFlightFences[currentFrame]);
-    syncObjects.fences.push_back(inFlightFences[currentFrame]);
-
-    auto result = vkQueueSubmit(device.graphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-    if (result != VK_SUCCESS) {
-        throw std::runtime_error("failed to submit draw command buffer!");
-    }
-
-    syncObjects.semaphores.clear();
-    syncObjects.semaphores.push_back((renderFinishedSemaphores)[currentFrame]);
-    return result;
+VkResult LveSwapChain::acquireNextImage(uint32_t *imageIndex) {
+    return vkAcquireNextImageKHR(device.device(), swapChain, std::numeric_limits<uint64_t>::max(),
+                                 imageAvailableSemaphores[currentFrame],  // must be a not signaled semaphore
+                                 VK_NULL_HANDLE, imageIndex);
 }
 
-VkResult LveSwapChain::presentImage(uint32_t *imageIndex, SynchronisationObjects &syncObjects) {
-    //   VkSemaphore waitSemaphores[] = {waitSemaphore};
-
+VkResult LveSwapChain::presentImage(uint32_t *imageIndex) {
     VkPresentInfoKHR presentInfo = {};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = syncObjects.semaphores.data();
+    presentInfo.pWaitSemaphores = &renderFinishedSemaphores[currentFrame];
 
     VkSwapchainKHR swapChains[] = {swapChain};
     presentInfo.swapchainCount = 1;
@@ -134,8 +124,7 @@ VkResult LveSwapChain::presentImage(uint32_t *imageIndex, SynchronisationObjects
     presentInfo.pImageIndices = imageIndex;
 
     auto result = vkQueuePresentKHR(device.presentQueue(), &presentInfo);
-    syncObjects.semaphores.clear();
-    currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    currentFrame = (currentFrame + 1) % framesInFlight;
     return result;
 }
 
@@ -143,7 +132,14 @@ void LveSwapChain::createSwapChain() {
     SwapChainSupportDetails swapChainSupport = device.getSwapChainSupport();
 
     VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
-    VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+    // les valeurs de la scène passent telles quelles d'une image unorm à la swapchain, comme si elle y était rendue
+    // directement
+    sceneColorFormat = surfaceFormat.format;
+    if (!isPostProcessingCompatibleFormat(surfaceFormat.format)) {
+        sceneColorFormat = POST_PROCESSING_STORAGE_FORMAT;
+        std::cout << "Swap chain format not readable by post processing, the final image is blitted" << std::endl;
+    }
+    presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
     VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
     uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
@@ -162,6 +158,27 @@ void LveSwapChain::createSwapChain() {
     createInfo.imageUsage =
         VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
+    // le format sRGB n'a pas de support storage : une vue rgba8 unorm est créée à côté, ce qui demande
+    // VK_KHR_swapchain_mutable_format. Sans elle, ou sans l'usage storage sur la surface, on garde la copie.
+    std::array<VkFormat, 2> viewFormats = {surfaceFormat.format, POST_PROCESSING_STORAGE_FORMAT};
+    VkImageFormatListCreateInfo formatListInfo{};
+    formatListInfo.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO;
+    formatListInfo.viewFormatCount = static_cast<uint32_t>(viewFormats.size());
+    formatListInfo.pViewFormats = viewFormats.data();
+
+    storageOutput = storageOutputRequested && isPostProcessingCompatibleFormat(surfaceFormat.format) &&
+                    (swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT) &&
+                    (surfaceFormat.format == POST_PROCESSING_STORAGE_FORMAT || device.supportsSwapchainMutableFormat());
+    if (storageOutput) {
+        createInfo.imageUsage |= VK_IMAGE_USAGE_STORAGE_BIT;
+        if (surfaceFormat.format != POST_PROCESSING_STORAGE_FORMAT) {
+            createInfo.flags = VK_SWAPCHAIN_CREATE_MUTABLE_FORMAT_BIT_KHR;
+            createInfo.pNext = &formatListInfo;
+        }
+    } else if (storageOutputRequested) {
+        std::cout << "Swap chain storage output not supported, post processing falls back to a copy" << std::endl;
+    }
+
     QueueFamilyIndices indices = device.findPhysicalQueueFamilies();
     // uint32_t queueFamilyIndices[] = {indices.graphicsFamily,
     // indices.presentFamily};
@@ -221,6 +238,21 @@ void LveSwapChain::createImageViews() {
             throw std::runtime_error("failed to create texture image view!");
         }
     }
+
+    if (!storageOutput) return;
+    swapChainStorageViews.resize(swapChainImages.size());
+    for (size_t i = 0; i < swapChainImages.size(); i++) {
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = swapChainImages[i];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = POST_PROCESSING_STORAGE_FORMAT;
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+        if (vkCreateImageView(device.device(), &viewInfo, nullptr, &swapChainStorageViews[i]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create swap chain storage image view!");
+        }
+    }
 }
 
 void LveSwapChain::createRenderPass() {
@@ -239,14 +271,15 @@ void LveSwapChain::createRenderPass() {
     depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
     VkAttachmentDescription colorAttachment = {};
-    colorAttachment.format = getSwapChainImageFormat();
+    colorAttachment.format = sceneColorFormat;
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // la cible de scène est lue ensuite par les compute shaders du post-processing
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_GENERAL;
 
     VkAttachmentReference colorAttachmentRef = {};
     colorAttachmentRef.attachment = 0;
@@ -281,12 +314,27 @@ void LveSwapChain::createRenderPass() {
     if (vkCreateRenderPass(device.device(), &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) {
         throw std::runtime_error("failed to create render pass!");
     }
+
+    // render pass compatible qui reprend le rendu en conservant couleur et profondeur (seconde phase du culling)
+    attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachments[0].initialLayout = VK_IMAGE_LAYOUT_GENERAL;
+    attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachments[1].initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                               VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    if (vkCreateRenderPass(device.device(), &renderPassInfo, nullptr, &loadRenderPass) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create render pass!");
+    }
 }
 
 void LveSwapChain::createFramebuffers() {
     swapChainFramebuffers.resize(imageCount());
     for (size_t i = 0; i < imageCount(); i++) {
-        std::array<VkImageView, 2> attachments = {swapChainImageViews[i], depthImageViews[i]};
+        std::array<VkImageView, 2> attachments = {sceneColorImageViews[i], depthImageViews[i]};
 
         VkExtent2D swapChainExtent = getSwapChainExtent();
         VkFramebufferCreateInfo framebufferInfo = {};
@@ -369,23 +417,86 @@ void LveSwapChain::createDepthResources() {
     }
 }
 
+void LveSwapChain::createSceneColorResources() {
+    VkExtent2D swapChainExtent = getSwapChainExtent();
+
+    sceneColorImages.resize(imageCount());
+    sceneColorImageMemorys.resize(imageCount());
+    sceneColorImageViews.resize(imageCount());
+    sceneColorStorageViews.resize(imageCount());
+
+    // même format que la swapchain quand c'est possible pour que la copie finale reste une copie brute, la vue
+    // storage partage les octets (l'ordre et l'encodage sRGB restent ceux de la swapchain, comme avec l'ancienne copie)
+    std::array<VkFormat, 2> viewFormats = {sceneColorFormat, POST_PROCESSING_STORAGE_FORMAT};
+    VkImageFormatListCreateInfo formatListInfo{};
+    formatListInfo.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO;
+    formatListInfo.viewFormatCount = static_cast<uint32_t>(viewFormats.size());
+    formatListInfo.pViewFormats = viewFormats.data();
+
+    for (int i = 0; i < sceneColorImages.size(); i++) {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = swapChainExtent.width;
+        imageInfo.extent.height = swapChainExtent.height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = sceneColorFormat;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT |
+                          VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.flags = 0;
+        if (sceneColorFormat != POST_PROCESSING_STORAGE_FORMAT) {
+            imageInfo.flags = VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+            imageInfo.pNext = &formatListInfo;
+        }
+
+        device.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, sceneColorImages[i],
+                                   sceneColorImageMemorys[i]);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = sceneColorImages[i];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = sceneColorFormat;
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+        if (vkCreateImageView(device.device(), &viewInfo, nullptr, &sceneColorImageViews[i]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create scene color image view!");
+        }
+
+        viewInfo.format = POST_PROCESSING_STORAGE_FORMAT;
+        if (vkCreateImageView(device.device(), &viewInfo, nullptr, &sceneColorStorageViews[i]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create scene color image view!");
+        }
+    }
+}
+
 void LveSwapChain::createSyncObjects() {
-    imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
-    imagesInFlight.resize(imageCount(), VK_NULL_HANDLE);
+    // les frames en vol de l'ancienne swapchain peuvent encore attendre ou signaler ces semaphores, ils sont repris
+    // pour qu'elle puisse être détruite plus tard par LveDevice::retire au lieu d'attendre que le device soit idle
+    if (oldSwapChain != nullptr) {
+        imageAvailableSemaphores = std::move(oldSwapChain->imageAvailableSemaphores);
+        renderFinishedSemaphores = std::move(oldSwapChain->renderFinishedSemaphores);
+        currentFrame = oldSwapChain->currentFrame;
+        oldSwapChain->imageAvailableSemaphores.clear();
+        oldSwapChain->renderFinishedSemaphores.clear();
+        return;
+    }
+
+    imageAvailableSemaphores.resize(framesInFlight);
+    renderFinishedSemaphores.resize(framesInFlight);
 
     VkSemaphoreCreateInfo semaphoreInfo = {};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceInfo = {};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (int i = 0; i < framesInFlight; i++) {
         if (vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS ||
-            vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &(renderFinishedSemaphores)[i]) != VK_SUCCESS ||
-            vkCreateFence(device.device(), &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS) {
+            vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &(renderFinishedSemaphores)[i]) != VK_SUCCESS) {
             throw std::runtime_error("failed to create synchronization objects for a frame!");
         }
     }
@@ -398,29 +509,44 @@ VkSurfaceFormatKHR LveSwapChain::chooseSwapSurfaceFormat(const std::vector<VkSur
             return availableFormat;
         }
     }
+    // sinon un format que les effets lisent par leur vue rgba8, pour garder la copie finale brute
+    for (const auto &availableFormat : availableFormats) {
+        if (isPostProcessingCompatibleFormat(availableFormat.format) &&
+            availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
+            return availableFormat;
+        }
+    }
 
     return availableFormats[0];
 }
 
 VkPresentModeKHR LveSwapChain::chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes) {
     for (const auto &availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-            std::cout << "Present mode: Mailbox" << std::endl;
+        if (availablePresentMode == requestedPresentMode) {
+            std::cout << "Present mode: " << presentModeName(availablePresentMode) << std::endl;
             return availablePresentMode;
         }
     }
 
-    // for (const auto &availablePresentMode : availablePresentModes) {
-    //   if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-    //     std::cout << "Present mode: Immediate" << std::endl;
-    //     return availablePresentMode;
-    //   }
-    // }
-
-    std::cout << "Present mode: V-Sync" << std::endl;
+    std::cout << "Present mode: " << presentModeName(VK_PRESENT_MODE_FIFO_KHR) << std::endl;
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+const char *LveSwapChain::presentModeName(VkPresentModeKHR presentMode) {
+    switch (presentMode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:
+            return "Immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR:
+            return "Mailbox";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+            return "V-Sync relaxed";
+        case VK_PRESENT_MODE_FIFO_KHR:
+            return "V-Sync";
+        default:
+            return "Unknown";
+    }
+}
+
 VkExtent2D LveSwapChain::chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities) {
     if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
         return capabilities.currentExtent;
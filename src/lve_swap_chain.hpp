@@ -15,10 +15,25 @@ namespace lve {
 
 class LveSwapChain {
    public:
-    static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
-
-    LveSwapChain(LveDevice &deviceRef, VkExtent2D windowExtent);
-    LveSwapChain(LveDevice &deviceRef, VkExtent2D windowExtent, std::shared_ptr<LveSwapChain> previous);
+    // bornes et valeur par défaut du nombre de frames en vol
+    static constexpr int MIN_FRAMES_IN_FLIGHT = 1;
+    static constexpr int MAX_FRAMES_IN_FLIGHT = 4;
+    static constexpr int DEFAULT_FRAMES_IN_FLIGHT = 2;
+    // vue des images de scène et de swapchain lues et écrites par les effets de post-processing (rgba8 en GLSL)
+    static constexpr VkFormat POST_PROCESSING_STORAGE_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+    // nombre de frames en vol, taille de toutes les ressources par frame du moteur (ubo, descriptor sets, textures
+    // de WaveGen et de post-processing). Fixé au lancement avant la création du renderer : 1 pour la latence
+    // minimale, 3 ou 4 pour le débit
+    static void setFramesInFlight(int count);
+    static int getFramesInFlight() { return framesInFlight; }
+
+    // storageOutput : demande des images de swapchain utilisables en storage image, si la surface le permet
+    // presentMode : mode demandé, FIFO (toujours disponible) s'il n'est pas supporté par la surface
+    LveSwapChain(LveDevice &deviceRef, VkExtent2D windowExtent, bool storageOutput = false,
+                 VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR);
+    LveSwapChain(LveDevice &deviceRef, VkExtent2D windowExtent, std::shared_ptr<LveSwapChain> previous,
+                 bool storageOutput, VkPresentModeKHR presentMode);
     ~LveSwapChain();
 
     LveSwapChain(const LveSwapChain &) = delete;
@@ -26,6 +41,7 @@ class LveSwapChain {
 
     VkFramebuffer getFrameBuffer(int index) { return swapChainFramebuffers[index]; }
     VkRenderPass getRenderPass() { return renderPass; }
+    VkRenderPass getLoadRenderPass() { return loadRenderPass; }
     VkImageView getImageView(int index) { return swapChainImageViews[index]; }
     size_t imageCount() { return swapChainImages.size(); }
     VkFormat getSwapChainImageFormat() { return swapChainImageFormat; }
@@ -38,38 +54,58 @@ class LveSwapChain {
     }
     VkFormat findDepthFormat();
 
-    VkResult acquireNextImage(uint32_t *imageIndex, SynchronisationObjects &syncObjects);
-    VkResult submitCommandBuffers(const VkCommandBuffer *buffers, uint32_t *imageIndex,
-                                  SynchronisationObjects &syncObjects);
-
-    VkResult presentImage(uint32_t *imageIndex, SynchronisationObjects &syncObjects);
+    // les frames en vol sont attendues par LveFrameSync avant l'acquisition
+    VkResult acquireNextImage(uint32_t *imageIndex);
+    VkResult presentImage(uint32_t *imageIndex);
 
-    VkSemaphore getActualRenderFinishedSemaphores() const { return renderFinishedSemaphores[currentFrame]; }
+    // semaphores binaires de la frame courante : signalé par l'acquisition, attendu par la présentation
+    VkSemaphore getImageAvailableSemaphore() const { return imageAvailableSemaphores[currentFrame]; }
+    VkSemaphore getRenderFinishedSemaphore() const { return renderFinishedSemaphores[currentFrame]; }
 
     VkImage getActualswapChainImages(uint32_t imageIndex) const { return swapChainImages[imageIndex]; }
 
     VkImage getActualDepthImages(uint32_t imageIndex) const { return depthImages[imageIndex]; }
 
+    // cible couleur de la passe de scène, consommée directement par le post-processing
+    VkImage getSceneColorImage(uint32_t imageIndex) const { return sceneColorImages[imageIndex]; }
+    // format de la swapchain si les effets savent le lire, POST_PROCESSING_STORAGE_FORMAT sinon
+    VkFormat getSceneColorFormat() const { return sceneColorFormat; }
+    // formats différents : l'image finale est blittée dans la swapchain, avec conversion, au lieu d'être copiée
+    bool needsOutputBlit() const { return sceneColorFormat != swapChainImageFormat; }
+
+    std::vector<VkImageView> getSceneColorStorageViews() const { return sceneColorStorageViews; }
+
+    // vide si les images de la swapchain ne peuvent pas servir de storage image
+    std::vector<VkImageView> getStorageImageViews() const { return swapChainStorageViews; }
+
+    bool hasStorageOutput() const { return storageOutput; }
+
+    // mode réellement utilisé
+    VkPresentModeKHR getPresentMode() const { return presentMode; }
+    static const char *presentModeName(VkPresentModeKHR presentMode);
+
     std::vector<VkImage> getDepthImages() const { return depthImages; }
 
     std::vector<VkImageView> getDepthImageViews() const { return depthImageViews; }
 
     std::vector<VkSampler> getDepthImagesSamplers() const { return depthImagesSamplers; }
 
-    VkFence getActualInFlightFences() const { return inFlightFences[currentFrame]; }
-
     bool compareSwapFormats(const LveSwapChain &swapChain) const {
         return swapChain.swapChainDepthFormat == swapChainDepthFormat &&
-               swapChain.swapChainImageFormat == swapChainImageFormat;
+               swapChain.swapChainImageFormat == swapChainImageFormat &&
+               swapChain.sceneColorFormat == sceneColorFormat;
     }
 
     int getCurrentFrameIndex() const { return currentFrame; }
 
    private:
+    static int framesInFlight;
+
     void init();
     void createSwapChain();
     void createImageViews();
     void createDepthResources();
+    void createSceneColorResources();
     void createRenderPass();
     void createFramebuffers();
     void createSyncObjects();
@@ -80,30 +116,40 @@ class LveSwapChain {
     VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities);
 
     VkFormat swapChainImageFormat;
+    VkFormat sceneColorFormat;
     VkFormat swapChainDepthFormat;
     VkExtent2D swapChainExtent;
 
     std::vector<VkFramebuffer> swapChainFramebuffers;
     VkRenderPass renderPass;
+    VkRenderPass loadRenderPass;
 
     std::vector<VkImage> depthImages;
     std::vector<VkDeviceMemory> depthImageMemorys;
     std::vector<VkImageView> depthImageViews;
     std::vector<VkSampler> depthImagesSamplers;
 
+    std::vector<VkImage> sceneColorImages;
+    std::vector<VkDeviceMemory> sceneColorImageMemorys;
+    std::vector<VkImageView> sceneColorImageViews;
+    std::vector<VkImageView> sceneColorStorageViews;
+
     std::vector<VkImage> swapChainImages;
     std::vector<VkImageView> swapChainImageViews;
+    std::vector<VkImageView> swapChainStorageViews;
 
     LveDevice &device;
     VkExtent2D windowExtent;
 
     VkSwapchainKHR swapChain;
     std::shared_ptr<LveSwapChain> oldSwapChain;
+    bool storageOutputRequested;
+    bool storageOutput = false;
+    VkPresentModeKHR requestedPresentMode;
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
 
     std::vector<VkSemaphore> imageAvailableSemaphores;
     std::vector<VkSemaphore> renderFinishedSemaphores;
-    std::vector<VkFence> inFlightFences;
-    std::vector<VkFence> imagesInFlight;
     size_t currentFrame = 0;
 };
 
@@ -4,6 +4,7 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <array>
 #include <cassert>
 #include <cstring>
 #include <filesystem>
@@ -29,8 +30,9 @@ LveTexture::LveTexture(LveDevice &device, const std::string &filepath, bool isCo
     }
 }
 
-LveTexture::LveTexture(LveDevice &device, int width, int height) : lveDevice{device}, width{width}, height{height} {
-    postprocessingTextureConstructor(width, height);
+LveTexture::LveTexture(LveDevice &device, int width, int height, VkFormat imageFormat)
+    : lveDevice{device}, width{width}, height{height} {
+    postprocessingTextureConstructor(width, height, imageFormat);
 }
 
 LveTexture::LveTexture(LveDevice &device, int width, int height, void *image, int numberOfChannels,
@@ -39,35 +41,13 @@ LveTexture::LveTexture(LveDevice &device, int width, int height, void *image, in
     cpuTextureConstructor(width, height, image, numberOfChannels, textureFormat);
 }
 
-void LveTexture::postprocessingTextureConstructor(int width, int height) {
-    LveBuffer stagingBuffer{lveDevice, 4, static_cast<u_int32_t>(width * height), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT};
-
-    imageFormat = VK_FORMAT_R8G8B8A8_UNORM;
-
-    VkImageCreateInfo imageInfo{};
-    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.format = imageFormat;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
-    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.extent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
-    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT |
-                      VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
-
-    lveDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
+void LveTexture::postprocessingTextureConstructor(int width, int height, VkFormat textureFormat) {
+    imageFormat = textureFormat;
+    createPostprocessingImage();
 
     transitionImageLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
     imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 
-    // lveDevice.copyBufferToImage(stagingBuffer.getBuffer(), textureImage,
-    // static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1,
-    // imageLayout);
-
     VkSamplerCreateInfo samplerInfo{};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     samplerInfo.magFilter = VK_FILTER_NEAREST;  // VK_FILTER_LINEAR
@@ -85,23 +65,80 @@ void LveTexture::postprocessingTextureConstructor(int width, int height) {
     samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_WHITE;  // VK_BORDER_COLOR_INT_OPAQUE_BLACK
 
     vkCreateSampler(lveDevice.device(), &samplerInfo, nullptr, &sampler);
+}
+
+void LveTexture::createPostprocessingImage() {
+    // les formats sans support storage (sRGB, BGRA) passent par une vue rgba8 unorm sur les mêmes octets
+    std::array<VkFormat, 2> viewFormats = {imageFormat, VK_FORMAT_R8G8B8A8_UNORM};
+    VkImageFormatListCreateInfo formatListInfo{};
+    formatListInfo.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_LIST_CREATE_INFO;
+    formatListInfo.viewFormatCount = static_cast<uint32_t>(viewFormats.size());
+    formatListInfo.pViewFormats = viewFormats.data();
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = imageFormat;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.extent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT |
+                      VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    if (imageFormat != VK_FORMAT_R8G8B8A8_UNORM) {
+        imageInfo.flags = VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+        imageInfo.pNext = &formatListInfo;
+    }
+
+    if (vkCreateImage(lveDevice.device(), &imageInfo, nullptr, &textureImage) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create image!");
+    }
+
+    // la mémoire déjà réservée est gardée tant qu'elle suffit, elle n'est réallouée que si l'image grandit
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(lveDevice.device(), textureImage, &memRequirements);
+    if (memRequirements.size > textureMemorySize) {
+        vkFreeMemory(lveDevice.device(), textureImageMemory, nullptr);
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex =
+            lveDevice.findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (vkAllocateMemory(lveDevice.device(), &allocInfo, nullptr, &textureImageMemory) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate image memory!");
+        }
+        textureMemorySize = memRequirements.size;
+    }
+
+    if (vkBindImageMemory(lveDevice.device(), textureImage, textureImageMemory, 0) != VK_SUCCESS) {
+        throw std::runtime_error("failed to bind image memory!");
+    }
 
     VkImageViewCreateInfo imageViewInfo{};
     imageViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    imageViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;  // VK_IMAGE_VIEW_TYPE_2D
-    imageViewInfo.format = imageFormat;
+    imageViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    imageViewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
     imageViewInfo.components = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B,
-                                VK_COMPONENT_SWIZZLE_A};                    // VK_COMPONENT_SWIZZLE_IDENTITY
-    imageViewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;  // VK_IMAGE_ASPECT_COLOR_BIT
-    imageViewInfo.subresourceRange.baseMipLevel = 0;
-    imageViewInfo.subresourceRange.baseArrayLayer = 0;
-    imageViewInfo.subresourceRange.layerCount = 1;
-    imageViewInfo.subresourceRange.levelCount = 1;
+                                VK_COMPONENT_SWIZZLE_A};
+    imageViewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
     imageViewInfo.image = textureImage;
 
     vkCreateImageView(lveDevice.device(), &imageViewInfo, nullptr, &imageView);
 }
 
+void LveTexture::resizePostprocessingTexture(int newWidth, int newHeight) {
+    vkDestroyImageView(lveDevice.device(), imageView, nullptr);
+    vkDestroyImage(lveDevice.device(), textureImage, nullptr);
+
+    width = newWidth;
+    height = newHeight;
+    createPostprocessingImage();
+}
+
 void LveTexture::objectTextureConstructor(const std::string &filepath) {
     int width, height, channels;
     int byPerPixel;
@@ -305,7 +342,8 @@ void LveTexture::transitionImageLayout(VkImageLayout oldLayout, VkImageLayout ne
 
 void LveTexture::cpuTextureConstructor(int width, int height, void *image, int numberOfChannels,
                                        VkFormat textureFormat) {
-    if (textureFormat == VK_FORMAT_R32G32_SFLOAT || textureFormat == VK_FORMAT_R32G32B32A32_SFLOAT)
+    if (textureFormat == VK_FORMAT_R32_SFLOAT || textureFormat == VK_FORMAT_R32G32_SFLOAT ||
+        textureFormat == VK_FORMAT_R32G32B32A32_SFLOAT)
         numberOfChannels = numberOfChannels * 4;
     LveBuffer stagingBuffer{lveDevice, (unsigned long)(unsigned int)numberOfChannels,
                             static_cast<u_int32_t>(width * height), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
@@ -436,10 +474,14 @@ void LveTexture::copyTexture(VkCommandBuffer commandBuffer, std::shared_ptr<LveT
 }
 
 LveTexture::~LveTexture() {
-    vkDestroyImage(lveDevice.device(), textureImage, nullptr);
-    vkFreeMemory(lveDevice.device(), textureImageMemory, nullptr);
-    vkDestroyImageView(lveDevice.device(), imageView, nullptr);
-    vkDestroySampler(lveDevice.device(), sampler, nullptr);
+    // les frames en vol peuvent encore lire la texture
+    lveDevice.retire([&device = lveDevice, image = textureImage, memory = textureImageMemory, view = imageView,
+                      sampler = sampler]() {
+        vkDestroyImage(device.device(), image, nullptr);
+        vkFreeMemory(device.device(), memory, nullptr);
+        vkDestroyImageView(device.device(), view, nullptr);
+        vkDestroySampler(device.device(), sampler, nullptr);
+    });
 }
 
 }  // namespace lve
\ No newline at end of file
@@ -11,7 +11,8 @@ namespace lve {
 class LveTexture {
    public:
     LveTexture(LveDevice& device, const std::string& filepath, bool isComputeTexture);
-    LveTexture(LveDevice& device, int width, int height);
+    // texture de post-processing, imageView est toujours une vue storage rgba8 unorm même si imageFormat diffère
+    LveTexture(LveDevice& device, int width, int height, VkFormat imageFormat = VK_FORMAT_R8G8B8A8_UNORM);
 
     LveTexture(LveDevice& device, int width, int height, void* image, int numberOfChannels, VkFormat textureFormat);
     ~LveTexture();
@@ -25,7 +26,11 @@ class LveTexture {
 
     void computeTextureConstructor(const std::string& filepath);
 
-    void postprocessingTextureConstructor(int width, int height);
+    void postprocessingTextureConstructor(int width, int height, VkFormat textureFormat);
+
+    // texture de post-processing uniquement : recrée l'image à la nouvelle taille dans la mémoire déjà allouée si
+    // elle suffit. L'image ne doit plus être utilisée par le GPU et reste en UNDEFINED jusqu'à sa première barrière
+    void resizePostprocessingTexture(int newWidth, int newHeight);
 
     void cpuTextureConstructor(int width, int height, void* image, int numberOfChannels, VkFormat textureFormat);
 
@@ -38,12 +43,14 @@ class LveTexture {
    private:
     LveDevice& lveDevice;
     VkImage textureImage;
-    VkDeviceMemory textureImageMemory;
+    VkDeviceMemory textureImageMemory = VK_NULL_HANDLE;
+    VkDeviceSize textureMemorySize = 0;
     VkImageView imageView;
     VkSampler sampler;
     VkFormat imageFormat;
     VkImageLayout imageLayout;
 
     void transitionImageLayout(VkImageLayout oldLayout, VkImageLayout newLayout);
+    void createPostprocessingImage();
 };
 }  // namespace lve
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "lve_texture_table.hpp"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace lve {
+
+LveTextureTable::LveTextureTable(LveDevice &device) : lveDevice{device} {
+    // update after bind : une texture peut être ajoutée pendant qu'une frame en vol utilise déjà le set
+    tablePool = LveDescriptorPool::Builder(lveDevice)
+                    .setMaxSets(1)
+                    .setPoolFlags(VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT)
+                    .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_TEXTURES)
+                    .build();
+
+    tableSetLayout = LveDescriptorSetLayout::Builder(lveDevice)
+                         .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT,
+                                     MAX_TEXTURES)
+                         .setBindingFlags(0, VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                                 VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT)
+                         .build();
+
+    if (!tablePool->allocateDescriptor(tableSetLayout->getDescriptorSetLayout(), tableDescriptorSet)) {
+        throw std::runtime_error("failed to allocate texture table descriptor set!");
+    }
+}
+
+uint32_t LveTextureTable::registerTexture(std::shared_ptr<LveTexture> texture) {
+    assert(texture != nullptr && "Cannot register a null texture");
+    auto it = textureIndices.find(texture.get());
+    if (it != textureIndices.end()) {
+        return it->second;
+    }
+
+    assert(textures.size() < MAX_TEXTURES && "Texture table is full");
+    uint32_t index = static_cast<uint32_t>(textures.size());
+    textures.push_back(texture);
+    textureIndices.emplace(texture.get(), index);
+
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = texture->getSampler();
+    imageInfo.imageView = texture->getImageView();
+    imageInfo.imageLayout = texture->getImageLayout();
+
+    // LveDescriptorWriter n'écrit que l'élément 0 d'un binding
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = tableDescriptorSet;
+    write.dstBinding = 0;
+    write.dstArrayElement = index;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.descriptorCount = 1;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(lveDevice.device(), 1, &write, 0, nullptr);
+
+    return index;
+}
+
+}  // namespace lve
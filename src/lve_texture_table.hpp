@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "lve_descriptor.hpp"
+#include "lve_device.hpp"
+#include "lve_texture.hpp"
+
+namespace lve {
+/**
+ * Table de textures bindless : un unique tableau de combined image samplers (descriptor indexing) lié une fois par
+ * frame. Chaque texture y est enregistrée une seule fois et les shaders l'adressent par son index.
+ */
+class LveTextureTable {
+   public:
+    static constexpr uint32_t MAX_TEXTURES = 1024;
+    // index des objets sans texture, doit correspondre à NO_TEXTURE dans simple_shader.frag
+    static constexpr uint32_t NO_TEXTURE = 0xFFFFFFFF;
+
+    LveTextureTable(LveDevice &device);
+    ~LveTextureTable() = default;
+
+    LveTextureTable(const LveTextureTable &) = delete;
+    LveTextureTable &operator=(const LveTextureTable &) = delete;
+
+    // renvoie l'index de la texture dans la table, l'écrit au premier enregistrement
+    uint32_t registerTexture(std::shared_ptr<LveTexture> texture);
+
+    uint32_t getTextureCount() const { return static_cast<uint32_t>(textures.size()); }
+    VkDescriptorSetLayout getDescriptorSetLayout() const { return tableSetLayout->getDescriptorSetLayout(); }
+    VkDescriptorSet getDescriptorSet() const { return tableDescriptorSet; }
+
+   private:
+    LveDevice &lveDevice;
+
+    // garde les textures en vie tant que la table les référence
+    std::vector<std::shared_ptr<LveTexture>> textures;
+    std::unordered_map<LveTexture *, uint32_t> textureIndices;
+
+    std::unique_ptr<LveDescriptorPool> tablePool;
+    std::unique_ptr<LveDescriptorSetLayout> tableSetLayout;
+    VkDescriptorSet tableDescriptorSet;
+};
+}  // namespace lve
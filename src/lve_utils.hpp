@@ -25,6 +25,20 @@ enum LvePipeLineType {
 enum LvePipelIneFunctionnality {
     None = 0,
     Transparancy = 1,
+    NoVertexInput = 2,  // les vertex sont générés à partir de gl_VertexIndex
+};
+
+// disposition des vertex d'un LveModel, passée aux shaders en constante de spécialisation (constant_id = 0)
+enum LveVertexFormat {
+    LveVertexFormatStandard = 0,         // LveModel::Vertex, fp32
+    LveVertexFormatCompressed = 1,       // LveModel::CompressedVertex
+    LveVertexFormatCompressedColor = 2,  // LveModel::CompressedVertex + flux de couleur RGBA8
+};
+
+// sortie de la chaîne de post-processing vers l'image de la swapchain
+enum LvePostOutputMode {
+    LvePostOutputCopy = 0,     // une copie de l'image de travail dans l'image de la swapchain
+    LvePostOutputStorage = 1,  // le dernier effet écrit directement dans l'image de la swapchain (storage image)
 };
 
 struct PipelineCreateInfo {
@@ -35,11 +49,7 @@ struct PipelineCreateInfo {
     uint32_t pushConstantRangeSize = 0;
     LvePipelIneFunctionnality functionnality = LvePipelIneFunctionnality::None;
     VkRenderPass renderPass;
-};
-
-struct SynchronisationObjects {
-    std::vector<VkSemaphore> semaphores;
-    std::vector<VkFence> fences;
+    LveVertexFormat vertexFormat = LveVertexFormatStandard;
 };
 
 }  // namespace lve
\ No newline at end of file
@@ -1,13 +1,120 @@
+#include <cerrno>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <exception>
 #include <iostream>
 #include <stdexcept>
 
 #include "first_app.hpp"
 
-int main() {
-    lve::FirstApp app{};
+static bool parsePresentMode(const char *name, VkPresentModeKHR &presentMode) {
+    if (std::strcmp(name, "fifo") == 0) {
+        presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    } else if (std::strcmp(name, "fifo_relaxed") == 0) {
+        presentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+    } else if (std::strcmp(name, "mailbox") == 0) {
+        presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+    } else if (std::strcmp(name, "immediate") == 0) {
+        presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool parseInt(const char *text, int min, int max, int &value) {
+    char *end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed < min || parsed > max) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+static bool parseFps(const char *text, float &value) {
+    char *end = nullptr;
+    errno = 0;
+    float parsed = std::strtof(text, &end);
+    if (end == text || *end != '\0' || errno == ERANGE || !std::isfinite(parsed) || parsed < 0.f) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+static int usage(const char *program) {
+    std::cerr << "usage: " << program
+              << " [--frames-in-flight 1-4] [--present-mode fifo|fifo_relaxed|mailbox|immediate] [--fps N]"
+                 " [--post-output copy|storage] [--pixel-effects] [--occlusion-benchmark]\n";
+    return EXIT_FAILURE;
+}
+
+int main(int argc, char **argv) {
+    // --frames-in-flight N : 1 pour la latence minimale, 3 ou 4 pour le débit (capture)
+    // --present-mode fifo|fifo_relaxed|mailbox|immediate : mode au lancement, changé ensuite avec la touche P
+    // --fps N : limite de la boucle de rendu, 0 sans limite
+    // --post-output copy|storage : sortie du post-processing au lancement, basculée ensuite avec la touche O
+    // --pixel-effects : ajoute l'étalonnage et la vignette fusionnés après les nuages
+    // --occlusion-benchmark : scène de test du culling, l'occlusion est ensuite basculée avec la touche H
+    lve::AppSettings settings{};
+    for (int i = 1; i < argc; i++) {
+        const char *option = argv[i];
+        // valeur de l'option, consommée pour ne pas être relue comme une option
+        const char *value = nullptr;
+        auto takeValue = [&]() {
+            if (i + 1 < argc) {
+                value = argv[++i];
+                return true;
+            }
+            std::cerr << "missing value for " << option << '\n';
+            return false;
+        };
+
+        if (std::strcmp(option, "--frames-in-flight") == 0) {
+            if (!takeValue()) return usage(argv[0]);
+            if (!parseInt(value, lve::LveSwapChain::MIN_FRAMES_IN_FLIGHT, lve::LveSwapChain::MAX_FRAMES_IN_FLIGHT,
+                          settings.framesInFlight)) {
+                std::cerr << "frames in flight must be between " << lve::LveSwapChain::MIN_FRAMES_IN_FLIGHT
+                          << " and " << lve::LveSwapChain::MAX_FRAMES_IN_FLIGHT << ", got " << value << '\n';
+                return usage(argv[0]);
+            }
+        } else if (std::strcmp(option, "--present-mode") == 0) {
+            if (!takeValue()) return usage(argv[0]);
+            if (!parsePresentMode(value, settings.presentMode)) {
+                std::cerr << "unknown present mode " << value << '\n';
+                return usage(argv[0]);
+            }
+        } else if (std::strcmp(option, "--fps") == 0) {
+            if (!takeValue()) return usage(argv[0]);
+            if (!parseFps(value, settings.targetFps)) {
+                std::cerr << "fps must be a positive number, 0 for no limit, got " << value << '\n';
+                return usage(argv[0]);
+            }
+        } else if (std::strcmp(option, "--post-output") == 0) {
+            if (!takeValue()) return usage(argv[0]);
+            if (std::strcmp(value, "copy") == 0) {
+                settings.postOutputMode = lve::LvePostOutputCopy;
+            } else if (std::strcmp(value, "storage") == 0) {
+                settings.postOutputMode = lve::LvePostOutputStorage;
+            } else {
+                std::cerr << "unknown post output " << value << '\n';
+                return usage(argv[0]);
+            }
+        } else if (std::strcmp(option, "--pixel-effects") == 0) {
+            settings.pixelEffects = true;
+        } else if (std::strcmp(option, "--occlusion-benchmark") == 0) {
+            settings.occlusionBenchmark = true;
+        } else {
+            std::cerr << "unknown option " << option << '\n';
+            return usage(argv[0]);
+        }
+    }
+
     try {
+        lve::FirstApp app{settings};
         app.run();
     } catch (const std::exception &e) {
         std::cerr << e.what() << '\n';
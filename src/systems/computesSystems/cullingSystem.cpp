@@ -0,0 +1,297 @@
+#include "cullingSystem.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "../pipeline_builder.hpp"
+#include "lve_c_pipeline.hpp"
+#include "lve_device.hpp"
+#include "lve_frame_info.hpp"
+#include "lve_swap_chain.hpp"
+#include "lve_utils.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_access.hpp>
+#include <memory>
+#include <stdexcept>
+
+namespace lve {
+
+// doit correspondre à ObjectData dans frustum_culling.comp et simple_shader.vert (std430)
+struct ObjectData {
+    glm::mat4 modelMatrix{1.f};
+    glm::mat4 normalMatrix{1.f};
+    glm::vec4 boundingSphere{0.f};  // xyz centre en espace objet, w rayon
+    glm::uvec4 drawInfo{0};         // x batch, y premier slot de commande du batch, z nombre de LOD, w texture
+};
+
+// doit correspondre à LodData dans frustum_culling.comp (std430), LveModel::MAX_LODS entrées par batch
+struct LodData {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float error;
+    uint32_t padding;
+};
+
+// doit correspondre à CullingUbo dans frustum_culling.comp (std140)
+struct CullingUbo {
+    glm::vec4 frustumPlanes[6];
+    glm::mat4 viewProjection{1.f};
+    glm::mat4 pyramidViewProjection{1.f};
+    glm::vec2 pyramidSize{0.f};
+    float pyramidMipLevels = 0.f;
+    float boundsMargin = 0.f;
+    float lodScale = 0.f;  // pixels par unité d'espace monde à distance 1
+    float lodErrorThreshold = 0.f;
+};
+
+struct SimplePushConstantData {
+    uint32_t objectCount;
+    uint32_t phase;
+    uint32_t occlusion;
+};
+
+// Les objets flottants sont déplacés par les vagues dans simple_shader.vert, on élargit donc leurs sphères
+static constexpr float WAVE_BOUNDS_MARGIN = 1.f;
+
+CullingSystem::CullingSystem(LveDevice &device, LveHiZPyramid &hiZPyramid)
+    : lveDevice{device}, hiZPyramid{hiZPyramid} {
+    createBuffers();
+    createDescriptorSets();
+
+    PipelineCreateInfo pipelineCreateInfo{device,
+                                          LvePipeLineType::LvePipeLineTypeCompute,
+                                          {cullingSetLayout->getDescriptorSetLayout(), hiZPyramid.getDescriptorSetLayout()},
+                                          {"shaders/frustum_culling.comp.spv"},
+                                          sizeof(SimplePushConstantData),
+                                          LvePipelIneFunctionnality::None,
+                                          nullptr};
+
+    pipelineLayout = PipelineBuilder::BuildPipeLineLayout(pipelineCreateInfo);
+    lveCPipeline = PipelineBuilder::BuildComputesPipeline(pipelineCreateInfo, pipelineLayout);
+}
+
+CullingSystem::~CullingSystem() { vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr); }
+
+void CullingSystem::createBuffers() {
+    objectBuffers.resize(LveSwapChain::getFramesInFlight());
+    drawCommandBuffers.resize(LveSwapChain::getFramesInFlight());
+    drawCountBuffers.resize(LveSwapChain::getFramesInFlight());
+    occlusionFlagBuffers.resize(LveSwapChain::getFramesInFlight());
+    cullingUboBuffers.resize(LveSwapChain::getFramesInFlight());
+    lodBuffers.resize(LveSwapChain::getFramesInFlight());
+
+    for (int i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
+        objectBuffers[i] = std::make_unique<LveBuffer>(lveDevice, sizeof(ObjectData), MAX_OBJECTS,
+                                                       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+        objectBuffers[i]->map();
+
+        // une région par phase de culling
+        drawCommandBuffers[i] = std::make_unique<LveBuffer>(
+            lveDevice, sizeof(VkDrawIndexedIndirectCommand), MAX_OBJECTS * 2,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        drawCountBuffers[i] = std::make_unique<LveBuffer>(
+            lveDevice, sizeof(uint32_t), MAX_BATCHES * 2,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        occlusionFlagBuffers[i] = std::make_unique<LveBuffer>(
+            lveDevice, sizeof(uint32_t), MAX_OBJECTS, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        cullingUboBuffers[i] = std::make_unique<LveBuffer>(lveDevice, sizeof(CullingUbo), 1,
+                                                           VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+        cullingUboBuffers[i]->map();
+
+        lodBuffers[i] = std::make_unique<LveBuffer>(lveDevice, sizeof(LodData), MAX_BATCHES * LveModel::MAX_LODS,
+                                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+        lodBuffers[i]->map();
+    }
+}
+
+void CullingSystem::createDescriptorSets() {
+    cullingPool = LveDescriptorPool::Builder(lveDevice)
+                      .setMaxSets(LveSwapChain::getFramesInFlight())
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, LveSwapChain::getFramesInFlight() * 5)
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, LveSwapChain::getFramesInFlight())
+                      .build();
+
+    // le set est aussi lié par SimpleRenderSystem pour lire les matrices des objets dans le vertex shader
+    cullingSetLayout =
+        LveDescriptorSetLayout::Builder(lveDevice)
+            .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT)
+            .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(4, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .addBinding(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .build();
+
+    cullingDescriptorSets.resize(LveSwapChain::getFramesInFlight());
+    for (int i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
+        auto objectInfo = objectBuffers[i]->descriptorInfo();
+        auto commandInfo = drawCommandBuffers[i]->descriptorInfo();
+        auto countInfo = drawCountBuffers[i]->descriptorInfo();
+        auto flagInfo = occlusionFlagBuffers[i]->descriptorInfo();
+        auto uboInfo = cullingUboBuffers[i]->descriptorInfo();
+        auto lodInfo = lodBuffers[i]->descriptorInfo();
+        LveDescriptorWriter(*cullingSetLayout, *cullingPool)
+            .writeBuffer(0, &objectInfo)
+            .writeBuffer(1, &commandInfo)
+            .writeBuffer(2, &countInfo)
+            .writeBuffer(3, &flagInfo)
+            .writeBuffer(4, &uboInfo)
+            .writeBuffer(5, &lodInfo)
+            .build(cullingDescriptorSets[i]);
+    }
+}
+
+uint32_t CullingSystem::fillObjectBuffer(FrameInfo &frameInfo) {
+    batches.clear();
+
+    // regroupe les objets par modèle pour obtenir une draw list par vertex buffer
+    std::unordered_map<LveModel *, uint32_t> batchIndices;
+    std::vector<std::vector<LveGameObject *>> batchObjects;
+    for (auto &kv : frameInfo.gameObjects) {
+        auto &obj = kv.second;
+        if (obj.model == nullptr || obj.water != nullptr) continue;
+        assert(obj.model->hasIndices() && "Culled objects must have an index buffer");
+
+        auto it = batchIndices.find(obj.model.get());
+        if (it == batchIndices.end()) {
+            assert(batches.size() < MAX_BATCHES && "Too many models for the culling pass");
+            it = batchIndices.emplace(obj.model.get(), static_cast<uint32_t>(batches.size())).first;
+            batches.push_back({obj.model, 0, 0, 0.f});
+            batchObjects.emplace_back();
+        }
+        batchObjects[it->second].push_back(&obj);
+    }
+
+    glm::vec3 cameraPosition = frameInfo.camera.getPosition();
+    uint32_t objectCount = 0;
+    uint32_t firstCommand = 0;
+    auto *objects = static_cast<ObjectData *>(objectBuffers[frameInfo.frameIndex]->getMappedMemory());
+    auto *lodData = static_cast<LodData *>(lodBuffers[frameInfo.frameIndex]->getMappedMemory());
+    for (uint32_t batchIndex = 0; batchIndex < batches.size(); batchIndex++) {
+        auto &batch = batches[batchIndex];
+        batch.firstCommand = firstCommand;
+        batch.maxDrawCount = static_cast<uint32_t>(batchObjects[batchIndex].size());
+        firstCommand += batch.maxDrawCount;
+
+        const LveModel::Bounds &bounds = batch.model->getBounds();
+        const auto &lods = batch.model->getLods();
+        for (uint32_t lod = 0; lod < lods.size(); lod++) {
+            lodData[batchIndex * LveModel::MAX_LODS + lod] = {lods[lod].firstIndex, lods[lod].indexCount,
+                                                              lods[lod].error, 0};
+        }
+        batch.nearestDistance = std::numeric_limits<float>::max();
+        for (LveGameObject *obj : batchObjects[batchIndex]) {
+            assert(objectCount < MAX_OBJECTS && "Too many objects for the culling pass");
+            ObjectData &data = objects[objectCount++];
+            data.modelMatrix = obj->transform.mat4();
+            data.normalMatrix = obj->transform.normalMatrix();
+            data.boundingSphere = glm::vec4(bounds.center, bounds.radius);
+            data.drawInfo =
+                glm::uvec4(batchIndex, batch.firstCommand, static_cast<uint32_t>(lods.size()), obj->textureIndex);
+
+            float scale = glm::max(obj->transform.scale.x, glm::max(obj->transform.scale.y, obj->transform.scale.z));
+            glm::vec3 center = glm::vec3(data.modelMatrix * glm::vec4(bounds.center, 1.f));
+            batch.nearestDistance = std::min(batch.nearestDistance,
+                                             glm::length(center - cameraPosition) - bounds.radius * scale);
+        }
+        batch.nearestDistance = std::max(batch.nearestDistance, 0.f);
+    }
+
+    objectBuffers[frameInfo.frameIndex]->flush();
+    lodBuffers[frameInfo.frameIndex]->flush();
+    return objectCount;
+}
+
+void CullingSystem::dispatch(VkCommandBuffer commandBuffer, int frameIndex, CullingPhase phase, bool occlusion) {
+    SimplePushConstantData push{};
+    push.objectCount = objectCount;
+    push.phase = phase;
+    push.occlusion = occlusion ? 1 : 0;
+
+    VkDescriptorSet descriptorSets[] = {cullingDescriptorSets[frameIndex], hiZPyramid.getDescriptorSet()};
+
+    lveCPipeline->bind(commandBuffer);
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SimplePushConstantData),
+                       &push);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 2, descriptorSets, 0,
+                            nullptr);
+    vkCmdDispatch(commandBuffer, objectCount / 64 + 1, 1, 1);
+
+    // les draw lists sont lues par le rendu (DRAW_INDIRECT), les flags par la phase late
+    VkMemoryBarrier memoryBarrier{};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                         &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+void CullingSystem::executePreCpS(FrameInfo frameInfo) {
+    VkCommandBuffer commandBuffer = frameInfo.preProcessingCommandBuffer;
+    objectCount = fillObjectBuffer(frameInfo);
+
+    // plans du frustum extraits de projection * view (Gribb & Hartmann), profondeur [0, 1]
+    glm::mat4 viewProjection = frameInfo.camera.getProjection() * frameInfo.camera.getView();
+    glm::vec4 row0 = glm::row(viewProjection, 0);
+    glm::vec4 row1 = glm::row(viewProjection, 1);
+    glm::vec4 row2 = glm::row(viewProjection, 2);
+    glm::vec4 row3 = glm::row(viewProjection, 3);
+
+    CullingUbo ubo{};
+    ubo.frustumPlanes[0] = row3 + row0;
+    ubo.frustumPlanes[1] = row3 - row0;
+    ubo.frustumPlanes[2] = row3 + row1;
+    ubo.frustumPlanes[3] = row3 - row1;
+    ubo.frustumPlanes[4] = row2;
+    ubo.frustumPlanes[5] = row3 - row2;
+    for (auto &plane : ubo.frustumPlanes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    ubo.viewProjection = viewProjection;
+    // la phase early teste contre la pyramide de la frame précédente, projetée avec ses propres matrices
+    ubo.pyramidViewProjection = pyramidViewProjection;
+    ubo.pyramidSize = glm::vec2(hiZPyramid.getExtent().width, hiZPyramid.getExtent().height);
+    ubo.pyramidMipLevels = static_cast<float>(hiZPyramid.getMipLevels());
+    ubo.boundsMargin = WAVE_BOUNDS_MARGIN;
+    ubo.lodScale = frameInfo.camera.getProjection()[1][1] * viewportHeight * 0.5f;
+    ubo.lodErrorThreshold = lodErrorThreshold;
+    cullingUboBuffers[frameInfo.frameIndex]->writeToBuffer(&ubo);
+    cullingUboBuffers[frameInfo.frameIndex]->flush();
+    pyramidViewProjection = viewProjection;
+
+    vkCmdFillBuffer(commandBuffer, drawCountBuffers[frameInfo.frameIndex]->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+
+    // la pyramide a été écrite par le command buffer de rendu de la frame précédente
+    VkMemoryBarrier memoryBarrier{};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+    if (objectCount == 0) return;
+    dispatch(commandBuffer, frameInfo.frameIndex, CullingPhaseEarly, occlusionCulling && hiZPyramid.isValid());
+}
+
+void CullingSystem::executeLateCulling(FrameInfo &frameInfo) {
+    if (objectCount == 0 || !occlusionCulling) return;
+    dispatch(frameInfo.commandBuffer, frameInfo.frameIndex, CullingPhaseLate, true);
+}
+
+}  // namespace lve
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../lve_Ipre_processing.hpp"
+#include "lve_buffer.hpp"
+#include "lve_c_pipeline.hpp"
+#include "lve_descriptor.hpp"
+#include "lve_device.hpp"
+#include "lve_frame_info.hpp"
+#include "lve_hiz_pyramid.hpp"
+#include "lve_model.hpp"
+
+namespace lve {
+
+enum CullingPhase {
+    CullingPhaseEarly = 0,  // pre-processing : frustum + occlusion contre la pyramide de la frame précédente
+    CullingPhaseLate = 1,   // après la première passe : objets rejetés retestés contre la pyramide fraîche
+};
+
+/**
+ * Teste les sphères englobantes de tous les objets contre le frustum de la caméra sur GPU et écrit, pour chaque
+ * modèle, une liste compactée de VkDrawIndexedIndirectCommand + un compteur consommés par vkCmdDrawIndexedIndirectCount.
+ * L'occlusion est testée en deux phases contre la pyramide Hi-Z (LveHiZPyramid). Chaque commande dessine le LOD
+ * (LveModel::Lod) le plus simple dont l'erreur projetée reste sous le seuil en pixels.
+ */
+class CullingSystem : public LveIPreProcessing {
+   public:
+    static constexpr uint32_t MAX_OBJECTS = 4096;
+    static constexpr uint32_t MAX_BATCHES = 64;
+    // erreur géométrique tolérée à l'écran, en pixels, avant de passer au LOD plus détaillé
+    static constexpr float DEFAULT_LOD_ERROR_THRESHOLD = 1.f;
+
+    // un batch regroupe les objets qui partagent le même modèle (mêmes vertex/index buffers), quelle que soit leur
+    // texture : elle est lue dans la LveTextureTable avec l'index de l'objet
+    struct DrawBatch {
+        std::shared_ptr<LveModel> model;
+        uint32_t firstCommand;
+        uint32_t maxDrawCount;
+        float nearestDistance;  // distance caméra de l'objet le plus proche, pour le tri de la render queue
+    };
+
+    CullingSystem(LveDevice &device, LveHiZPyramid &hiZPyramid);
+    ~CullingSystem();
+
+    CullingSystem(const CullingSystem &) = delete;
+    CullingSystem &operator=(const CullingSystem &) = delete;
+
+    // phase early, dans le command buffer de pre-processing
+    void executePreCpS(FrameInfo frameInfo) override;
+    // phase late, dans le command buffer de rendu entre les deux passes, après LveRenderer::buildDepthPyramid
+    void executeLateCulling(FrameInfo &frameInfo);
+
+    void setOcclusionCulling(bool enabled) { occlusionCulling = enabled; }
+    void setLodErrorThreshold(float pixels) { lodErrorThreshold = pixels; }
+    // hauteur en pixels du viewport, pour projeter l'erreur des LOD
+    void setViewportHeight(float height) { viewportHeight = height; }
+
+    const std::vector<DrawBatch> &getBatches() const { return batches; }
+    VkDeviceSize getDrawCommandOffset(CullingPhase phase) const {
+        return phase * MAX_OBJECTS * sizeof(VkDrawIndexedIndirectCommand);
+    }
+    VkDeviceSize getDrawCountOffset(CullingPhase phase) const { return phase * MAX_BATCHES * sizeof(uint32_t); }
+    VkBuffer getDrawCommandBuffer(int frameIndex) const { return drawCommandBuffers[frameIndex]->getBuffer(); }
+    VkBuffer getDrawCountBuffer(int frameIndex) const { return drawCountBuffers[frameIndex]->getBuffer(); }
+    VkDescriptorSet getDescriptorSet(int frameIndex) const { return cullingDescriptorSets[frameIndex]; }
+    VkDescriptorSetLayout getDescriptorSetLayout() const { return cullingSetLayout->getDescriptorSetLayout(); }
+
+   private:
+    void createBuffers();
+    void createDescriptorSets();
+    uint32_t fillObjectBuffer(FrameInfo &frameInfo);
+    void dispatch(VkCommandBuffer commandBuffer, int frameIndex, CullingPhase phase, bool occlusion);
+
+    LveDevice &lveDevice;
+    LveHiZPyramid &hiZPyramid;
+
+    bool occlusionCulling = true;
+    float lodErrorThreshold = DEFAULT_LOD_ERROR_THRESHOLD;
+    float viewportHeight = 1.f;
+    uint32_t objectCount = 0;
+    // matrice avec laquelle la pyramide courante a été construite
+    glm::mat4 pyramidViewProjection{1.f};
+
+    std::vector<DrawBatch> batches;
+    std::vector<std::unique_ptr<LveBuffer>> objectBuffers;
+    std::vector<std::unique_ptr<LveBuffer>> drawCommandBuffers;
+    std::vector<std::unique_ptr<LveBuffer>> drawCountBuffers;
+    std::vector<std::unique_ptr<LveBuffer>> occlusionFlagBuffers;
+    std::vector<std::unique_ptr<LveBuffer>> cullingUboBuffers;
+    std::vector<std::unique_ptr<LveBuffer>> lodBuffers;
+
+    std::unique_ptr<LveDescriptorPool> cullingPool;
+    std::unique_ptr<LveDescriptorSetLayout> cullingSetLayout;
+    std::vector<VkDescriptorSet> cullingDescriptorSets;
+
+    std::unique_ptr<LveCPipeline> lveCPipeline;
+    VkPipelineLayout pipelineLayout;
+};
+}  // namespace lve
@@ -0,0 +1,141 @@
+#include "lightCullingSystem.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "../pipeline_builder.hpp"
+#include "lve_c_pipeline.hpp"
+#include "lve_device.hpp"
+#include "lve_frame_info.hpp"
+#include "lve_swap_chain.hpp"
+#include "lve_utils.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <memory>
+#include <stdexcept>
+
+namespace lve {
+
+struct SimplePushConstantData {
+    uint32_t lightCount;
+};
+
+static constexpr uint32_t INITIAL_LIGHT_CAPACITY = 64;
+
+LightCullingSystem::LightCullingSystem(LveDevice &device, VkDescriptorSetLayout globalSetLayout) : lveDevice{device} {
+    createBuffers();
+    createDescriptorSets();
+
+    PipelineCreateInfo pipelineCreateInfo{device,
+                                          LvePipeLineType::LvePipeLineTypeCompute,
+                                          {globalSetLayout, lightSetLayout->getDescriptorSetLayout()},
+                                          {"shaders/light_culling.comp.spv"},
+                                          sizeof(SimplePushConstantData),
+                                          LvePipelIneFunctionnality::None,
+                                          nullptr};
+
+    pipelineLayout = PipelineBuilder::BuildPipeLineLayout(pipelineCreateInfo);
+    lveCPipeline = PipelineBuilder::BuildComputesPipeline(pipelineCreateInfo, pipelineLayout);
+}
+
+LightCullingSystem::~LightCullingSystem() { vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr); }
+
+void LightCullingSystem::createLightBuffer(int frameIndex, uint32_t capacity) {
+    lightBuffers[frameIndex] = std::make_unique<LveBuffer>(lveDevice, sizeof(PointLight), capacity,
+                                                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+    lightBuffers[frameIndex]->map();
+}
+
+void LightCullingSystem::createBuffers() {
+    lightCounts.resize(LveSwapChain::getFramesInFlight(), 0);
+    lightBuffers.resize(LveSwapChain::getFramesInFlight());
+    clusterCountBuffers.resize(LveSwapChain::getFramesInFlight());
+    clusterIndexBuffers.resize(LveSwapChain::getFramesInFlight());
+
+    for (int i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
+        createLightBuffer(i, INITIAL_LIGHT_CAPACITY);
+
+        clusterCountBuffers[i] = std::make_unique<LveBuffer>(
+            lveDevice, sizeof(uint32_t), CLUSTER_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        clusterIndexBuffers[i] = std::make_unique<LveBuffer>(lveDevice, sizeof(uint32_t),
+                                                             CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER,
+                                                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+}
+
+void LightCullingSystem::createDescriptorSets() {
+    lightPool = LveDescriptorPool::Builder(lveDevice)
+                    .setMaxSets(LveSwapChain::getFramesInFlight())
+                    .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, LveSwapChain::getFramesInFlight() * 3)
+                    .build();
+
+    // le set est aussi lié par les systèmes de rendu pour lire les listes de lumières dans les fragment shaders
+    lightSetLayout =
+        LveDescriptorSetLayout::Builder(lveDevice)
+            .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
+            .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
+            .addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
+            .build();
+
+    lightDescriptorSets.resize(LveSwapChain::getFramesInFlight());
+    for (int i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
+        auto lightInfo = lightBuffers[i]->descriptorInfo();
+        auto countInfo = clusterCountBuffers[i]->descriptorInfo();
+        auto indexInfo = clusterIndexBuffers[i]->descriptorInfo();
+        LveDescriptorWriter(*lightSetLayout, *lightPool)
+            .writeBuffer(0, &lightInfo)
+            .writeBuffer(1, &countInfo)
+            .writeBuffer(2, &indexInfo)
+            .build(lightDescriptorSets[i]);
+    }
+}
+
+void LightCullingSystem::writeLights(int frameIndex, const std::vector<PointLight> &lights) {
+    // le buffer de cette frame n'est plus utilisé par le GPU, on peut le remplacer
+    if (lights.size() > lightBuffers[frameIndex]->getInstanceCount()) {
+        uint32_t capacity = std::max(static_cast<uint32_t>(lights.size()), lightBuffers[frameIndex]->getInstanceCount() * 2);
+        createLightBuffer(frameIndex, capacity);
+        auto lightInfo = lightBuffers[frameIndex]->descriptorInfo();
+        LveDescriptorWriter(*lightSetLayout, *lightPool)
+            .writeBuffer(0, &lightInfo)
+            .overwrite(lightDescriptorSets[frameIndex]);
+    }
+
+    lightCounts[frameIndex] = static_cast<uint32_t>(lights.size());
+    if (lights.empty()) return;
+    lightBuffers[frameIndex]->writeToBuffer(const_cast<PointLight *>(lights.data()), lights.size() * sizeof(PointLight));
+    lightBuffers[frameIndex]->flush();
+}
+
+void LightCullingSystem::executePreCpS(FrameInfo frameInfo) {
+    VkCommandBuffer commandBuffer = frameInfo.preProcessingCommandBuffer;
+
+    SimplePushConstantData push{};
+    push.lightCount = lightCounts[frameInfo.frameIndex];
+
+    VkDescriptorSet descriptorSets[] = {frameInfo.globalDescriptorSet, lightDescriptorSets[frameInfo.frameIndex]};
+
+    lveCPipeline->bind(commandBuffer);
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SimplePushConstantData),
+                       &push);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 2, descriptorSets, 0,
+                            nullptr);
+    vkCmdDispatch(commandBuffer, (CLUSTER_COUNT + 63) / 64, 1, 1);
+
+    // les listes de lumières sont lues par les fragment shaders du rendu
+    VkMemoryBarrier memoryBarrier{};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                         1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+}  // namespace lve
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../lve_Ipre_processing.hpp"
+#include "lve_buffer.hpp"
+#include "lve_c_pipeline.hpp"
+#include "lve_descriptor.hpp"
+#include "lve_device.hpp"
+#include "lve_frame_info.hpp"
+
+namespace lve {
+
+/**
+ * Clustered forward lighting : découpe le frustum en une grille de froxels (tranches de profondeur exponentielles) et
+ * écrit pour chaque cluster la liste des point lights qui le touchent. Les fragment shaders ne bouclent que sur les
+ * lumières de leur cluster.
+ */
+class LightCullingSystem : public LveIPreProcessing {
+   public:
+    // doit correspondre aux constantes de shaders/light_clusters.glsl
+    static constexpr uint32_t CLUSTER_X = 16;
+    static constexpr uint32_t CLUSTER_Y = 9;
+    static constexpr uint32_t CLUSTER_Z = 24;
+    static constexpr uint32_t CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+    // plafond de la liste d'un cluster : les lumières en trop sont ignorées sans signalement, ce cluster est alors
+    // éclairé seulement par les MAX_LIGHTS_PER_CLUSTER premières lumières du buffer qui le touchent
+    static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 128;
+
+    LightCullingSystem(LveDevice &device, VkDescriptorSetLayout globalSetLayout);
+    ~LightCullingSystem();
+
+    LightCullingSystem(const LightCullingSystem &) = delete;
+    LightCullingSystem &operator=(const LightCullingSystem &) = delete;
+
+    // copie les lumières de la frame, le buffer grandit si besoin
+    void writeLights(int frameIndex, const std::vector<PointLight> &lights);
+
+    void executePreCpS(FrameInfo frameInfo) override;
+
+    VkDescriptorSet getDescriptorSet(int frameIndex) const { return lightDescriptorSets[frameIndex]; }
+    VkDescriptorSetLayout getDescriptorSetLayout() const { return lightSetLayout->getDescriptorSetLayout(); }
+
+   private:
+    void createLightBuffer(int frameIndex, uint32_t capacity);
+    void createBuffers();
+    void createDescriptorSets();
+
+    LveDevice &lveDevice;
+
+    std::vector<uint32_t> lightCounts;
+    std::vector<std::unique_ptr<LveBuffer>> lightBuffers;
+    std::vector<std::unique_ptr<LveBuffer>> clusterCountBuffers;
+    std::vector<std::unique_ptr<LveBuffer>> clusterIndexBuffers;
+
+    std::unique_ptr<LveDescriptorPool> lightPool;
+    std::unique_ptr<LveDescriptorSetLayout> lightSetLayout;
+    std::vector<VkDescriptorSet> lightDescriptorSets;
+
+    std::unique_ptr<LveCPipeline> lveCPipeline;
+    VkPipelineLayout pipelineLayout;
+};
+}  // namespace lve
@@ -0,0 +1,64 @@
+#include "pixelEffectSystem.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include "../pipeline_builder.hpp"
+#include "lve_c_pipeline.hpp"
+#include "lve_device.hpp"
+#include "lve_frame_info.hpp"
+#include "lve_post_fusion.hpp"
+#include "lve_utils.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef ENGINE_DIR
+#define ENGINE_DIR "../"
+#endif
+
+namespace lve {
+
+PixelEffectSystem::PixelEffectSystem(LveDevice &device, VkDescriptorSetLayout textureSetLayout,
+                                     VkDescriptorSetLayout depthSetLayout, const std::string &name,
+                                     glm::vec4 parameters)
+    : lveDevice{device}, parameters{parameters} {
+    std::ifstream sourceFile(ENGINE_DIR "shaders/" + name + ".glsl");
+    if (!sourceFile.is_open()) {
+        throw std::runtime_error("failed to open pixel effect source : " + name);
+    }
+    std::stringstream source;
+    source << sourceFile.rdbuf();
+    pixelFunction = source.str();
+
+    // même layout que les shaders fusionnés : un vec4 de params par effet
+    PipelineCreateInfo pipelineCreateInfo{device,
+                                          LvePipeLineType::LvePipeLineTypeCompute,
+                                          {textureSetLayout, depthSetLayout},
+                                          {"shaders/" + name + ".comp.spv"},
+                                          LvePostFusion::PUSH_CONSTANT_SIZE,
+                                          LvePipelIneFunctionnality::None,
+                                          nullptr};
+
+    pipelineLayout = PipelineBuilder::BuildPipeLineLayout(pipelineCreateInfo);
+    lveCPipeline = PipelineBuilder::BuildComputesPipeline(pipelineCreateInfo, pipelineLayout);
+}
+
+PixelEffectSystem::~PixelEffectSystem() { vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr); }
+
+void PixelEffectSystem::executePostCpS(FrameInfo frameInfo, VkDescriptorSet computeDescriptorSets,
+                                       VkDescriptorSet depthDescriptorSets, VkExtent2D windowExtent) {
+    VkDescriptorSet descriptorSet[] = {computeDescriptorSets, depthDescriptorSets};
+
+    lveCPipeline->bind(frameInfo.postProcessingCommandBuffer);
+
+    vkCmdPushConstants(frameInfo.postProcessingCommandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                       sizeof(glm::vec4), &parameters);
+
+    vkCmdBindDescriptorSets(frameInfo.postProcessingCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 2,
+                            descriptorSet, 0, 0);
+
+    vkCmdDispatch(frameInfo.postProcessingCommandBuffer, (windowExtent.width + 15) / 16,
+                  (windowExtent.height + 15) / 16, 1);
+}
+}  // namespace lve
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <memory>
+#include <string>
+
+#include "../lve_Ipost_processing.hpp"
+#include "lve_c_pipeline.hpp"
+#include "lve_device.hpp"
+#include "lve_frame_info.hpp"
+
+namespace lve {
+/**
+ * Effet de post-processing purement par pixel décrit par shaders/<name>.glsl. Le LvePostProcessingManager le fusionne
+ * avec ses voisins du même type, son propre shader (shaders/<name>.comp) ne sert que s'il est seul ou que la fusion
+ * est impossible.
+ */
+class PixelEffectSystem : public LveIPostProcessing {
+   public:
+    PixelEffectSystem(LveDevice &device, VkDescriptorSetLayout textureSetLayout, VkDescriptorSetLayout depthSetLayout,
+                      const std::string &name, glm::vec4 parameters = glm::vec4{0.f});
+    ~PixelEffectSystem();
+
+    void executePostCpS(FrameInfo FrameInfo, VkDescriptorSet computeDescriptorSets, VkDescriptorSet depthDescriptorSets,
+                        VkExtent2D extent) override;
+
+    std::string getPixelFunction() const override { return pixelFunction; }
+    glm::vec4 getPixelParameters() const override { return parameters; }
+
+    void setParameters(glm::vec4 newParameters) { parameters = newParameters; }
+
+   private:
+    LveDevice &lveDevice;
+    std::string pixelFunction;
+    glm::vec4 parameters;
+    std::unique_ptr<LveCPipeline> lveCPipeline;
+    VkPipelineLayout pipelineLayout;
+};
+}  // namespace lve
@@ -22,6 +22,7 @@ namespace lve {
 
 struct SimplePushConstantData {
     glm::vec2 resolution;
+    int steps;
 };
 
 ShaderToySystem::ShaderToySystem(LveDevice &device, VkDescriptorSetLayout globalSetLayout,
@@ -48,6 +49,7 @@ void ShaderToySystem::executePostCpS(FrameInfo frameInfo, VkDescriptorSet comput
 
     SimplePushConstantData push{};
     push.resolution = glm::vec2(windowExtent.width, windowExtent.height);
+    push.steps = stepCount;
     vkCmdPushConstants(frameInfo.postProcessingCommandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
                        sizeof(SimplePushConstantData), &push);
 
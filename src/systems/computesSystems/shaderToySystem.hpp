@@ -12,6 +12,8 @@
 namespace lve {
 class ShaderToySystem : public LveIPostProcessing {
    public:
+    static constexpr int DEFAULT_STEPS = 200;
+
     ShaderToySystem(LveDevice &device, VkDescriptorSetLayout globalSetLayout, VkDescriptorSetLayout textureSetLayout,
                     VkDescriptorSetLayout depthSetLayout);
     ~ShaderToySystem();
@@ -19,10 +21,14 @@ class ShaderToySystem : public LveIPostProcessing {
     void executePostCpS(FrameInfo FrameInfo, VkDescriptorSet computeDescriptorSets, VkDescriptorSet depthDescriptorSets,
                         VkExtent2D extent) override;
 
+    // nombre maximum de pas de la raymarche, réglé par le LvePerformanceGovernor
+    void setStepCount(int steps) { stepCount = steps; }
+
    private:
     void createdescriptorSet();
 
     LveDevice &lveDevice;
+    int stepCount = DEFAULT_STEPS;
     std::unique_ptr<LveCPipeline> lveCPipeline;
     VkDescriptorPool descriptorPool;
     VkDescriptorSetLayout descriptorSetLayout;
@@ -0,0 +1,543 @@
+#include "volumetricCloudSystem.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../pipeline_builder.hpp"
+#include "lve_utils.hpp"
+
+namespace lve {
+
+// commun aux trois shaders clouds_march, clouds_temporal et clouds_upsample
+struct CloudPushConstantData {
+    glm::mat4 previousViewProjection;
+    glm::vec2 resolution;
+    glm::vec2 lowResolution;
+    int steps;
+    uint32_t frameCounter;
+    float historyWeight;
+    uint32_t bakedNoise;
+};
+
+// CloudShape en std140 dans clouds_march.comp et clouds_grid.comp
+struct CloudShapeUbo {
+    glm::vec4 spheres[VolumetricCloudSystem::MAX_CLOUD_SPHERES];
+    glm::vec4 boundsMin;  // w : VolumetricCloudSystem::NOISE_DISPLACEMENT_BOUND
+    glm::vec4 boundsMax;
+    int sphereCount;
+};
+
+// void-and-cluster (Ulichney 1993) sur un tore : chaque rang est placé dans le plus grand vide du motif courant,
+// ce qui donne un bruit sans basse fréquence
+static std::vector<float> generateBlueNoise(uint32_t size) {
+    const uint32_t count = size * size;
+    const float sigma = 1.5f;
+
+    std::vector<float> kernel(count);
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            float dx = static_cast<float>(std::min(x, size - x));
+            float dy = static_cast<float>(std::min(y, size - y));
+            kernel[y * size + x] = std::exp(-(dx * dx + dy * dy) / (2.f * sigma * sigma));
+        }
+    }
+
+    std::vector<float> energy(count, 0.f);
+    std::vector<bool> pattern(count, false);
+    auto splat = [&](uint32_t index, float sign) {
+        uint32_t px = index % size;
+        uint32_t py = index / size;
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                energy[y * size + x] += sign * kernel[((y + size - py) % size) * size + (x + size - px) % size];
+            }
+        }
+    };
+    auto tightestCluster = [&]() {
+        uint32_t best = 0;
+        float bestEnergy = -1.f;
+        for (uint32_t i = 0; i < count; i++) {
+            if (pattern[i] && energy[i] > bestEnergy) {
+                bestEnergy = energy[i];
+                best = i;
+            }
+        }
+        return best;
+    };
+    auto largestVoid = [&]() {
+        uint32_t best = 0;
+        float bestEnergy = std::numeric_limits<float>::max();
+        for (uint32_t i = 0; i < count; i++) {
+            if (!pattern[i] && energy[i] < bestEnergy) {
+                bestEnergy = energy[i];
+                best = i;
+            }
+        }
+        return best;
+    };
+
+    // motif initial aléatoire (graine fixe), relaxé jusqu'à ce que le point le plus serré soit aussi le plus grand vide
+    std::mt19937 random{1993};
+    uint32_t initialCount = count / 10;
+    for (uint32_t placed = 0; placed < initialCount;) {
+        uint32_t index = random() % count;
+        if (pattern[index]) continue;
+        pattern[index] = true;
+        splat(index, 1.f);
+        placed++;
+    }
+    while (true) {
+        uint32_t cluster = tightestCluster();
+        pattern[cluster] = false;
+        splat(cluster, -1.f);
+        uint32_t hole = largestVoid();
+        pattern[hole] = true;
+        splat(hole, 1.f);
+        if (hole == cluster) break;
+    }
+
+    std::vector<uint32_t> ranks(count, 0);
+    std::vector<bool> initialPattern = pattern;
+    std::vector<float> initialEnergy = energy;
+    for (uint32_t rank = initialCount; rank-- > 0;) {
+        uint32_t cluster = tightestCluster();
+        pattern[cluster] = false;
+        splat(cluster, -1.f);
+        ranks[cluster] = rank;
+    }
+
+    pattern = initialPattern;
+    energy = initialEnergy;
+    for (uint32_t rank = initialCount; rank < count; rank++) {
+        uint32_t hole = largestVoid();
+        pattern[hole] = true;
+        splat(hole, 1.f);
+        ranks[hole] = rank;
+    }
+
+    std::vector<float> noise(count);
+    for (uint32_t i = 0; i < count; i++) {
+        noise[i] = (static_cast<float>(ranks[i]) + 0.5f) / static_cast<float>(count);
+    }
+    return noise;
+}
+
+VolumetricCloudSystem::VolumetricCloudSystem(LveDevice &device, VkDescriptorSetLayout globalSetLayout,
+                                             VkDescriptorSetLayout textureSetLayout,
+                                             VkDescriptorSetLayout depthSetLayout, uint32_t resolutionDivisor)
+    : lveDevice{device}, resolutionDivisor{resolutionDivisor} {
+    assert(resolutionDivisor >= 1 && "cloud resolution divisor must be at least 1");
+
+    cloudSetLayout = LveDescriptorSetLayout::Builder(lveDevice)
+                         .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+                         .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+                         .addBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+                         .addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+                         .addBinding(4, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+                         .addBinding(5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+                         .addBinding(6, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                         .addBinding(7, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+                         .build();
+
+    gridSetLayout = LveDescriptorSetLayout::Builder(lveDevice)
+                        .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                        .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+                        .build();
+
+    PipelineCreateInfo pipelineCreateInfo{
+        device,
+        LvePipeLineType::LvePipeLineTypeCompute,
+        {globalSetLayout, textureSetLayout, depthSetLayout, cloudSetLayout->getDescriptorSetLayout()},
+        {"shaders/clouds_march.comp.spv"},
+        sizeof(CloudPushConstantData),
+        LvePipelIneFunctionnality::None,
+        nullptr};
+
+    pipelineLayout = PipelineBuilder::BuildPipeLineLayout(pipelineCreateInfo);
+    marchPipeline = PipelineBuilder::BuildComputesPipeline(pipelineCreateInfo, pipelineLayout);
+    pipelineCreateInfo.shaderPaths = {"shaders/clouds_temporal.comp.spv"};
+    temporalPipeline = PipelineBuilder::BuildComputesPipeline(pipelineCreateInfo, pipelineLayout);
+    pipelineCreateInfo.shaderPaths = {"shaders/clouds_upsample.comp.spv"};
+    upsamplePipeline = PipelineBuilder::BuildComputesPipeline(pipelineCreateInfo, pipelineLayout);
+
+    PipelineCreateInfo gridPipelineCreateInfo{device,
+                                              LvePipeLineType::LvePipeLineTypeCompute,
+                                              {gridSetLayout->getDescriptorSetLayout()},
+                                              {"shaders/clouds_grid.comp.spv"},
+                                              0,
+                                              LvePipelIneFunctionnality::None,
+                                              nullptr};
+    gridPipelineLayout = PipelineBuilder::BuildPipeLineLayout(gridPipelineCreateInfo);
+    gridPipeline = PipelineBuilder::BuildComputesPipeline(gridPipelineCreateInfo, gridPipelineLayout);
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.compareOp = VK_COMPARE_OP_NEVER;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = 0.0f;
+    samplerInfo.anisotropyEnable = VK_FALSE;
+    samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+    if (vkCreateSampler(lveDevice.device(), &samplerInfo, nullptr, &historySampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create cloud history sampler!");
+    }
+
+    createBlueNoise();
+    noiseVolume = std::make_unique<LveNoiseVolume>(lveDevice);
+
+    // mis à jour dans le command buffer par vkCmdUpdateBuffer, pas de copie CPU pendant qu'une frame le lit
+    cloudShapeBuffer = std::make_unique<LveBuffer>(
+        lveDevice, sizeof(CloudShapeUbo), 1, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    createOccupancyGrid();
+
+    // les trois sphères d'origine de clouds.comp
+    setCloudSpheres({{-10.f, -4.f, -10.f, 4.f}, {-10.f, 0.f, -10.f, 5.f}, {-10.f, 4.f, -10.f, 4.f}});
+}
+
+VolumetricCloudSystem::~VolumetricCloudSystem() {
+    destroyImages();
+    vkDestroySampler(lveDevice.device(), historySampler, nullptr);
+    vkDestroySampler(lveDevice.device(), occupancyGridSampler, nullptr);
+    vkDestroyImageView(lveDevice.device(), occupancyGrid.view, nullptr);
+    vkDestroyImage(lveDevice.device(), occupancyGrid.image, nullptr);
+    vkFreeMemory(lveDevice.device(), occupancyGrid.memory, nullptr);
+    vkDestroyPipelineLayout(lveDevice.device(), gridPipelineLayout, nullptr);
+    vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr);
+}
+
+void VolumetricCloudSystem::setCloudSpheres(const std::vector<glm::vec4> &spheres) {
+    assert(spheres.size() <= MAX_CLOUD_SPHERES && "too many cloud spheres");
+    cloudSpheres = spheres;
+    cloudShapeDirty = true;
+}
+
+void VolumetricCloudSystem::createBlueNoise() {
+    std::vector<float> noise = generateBlueNoise(BLUE_NOISE_SIZE);
+    blueNoise = std::make_shared<LveTexture>(lveDevice, BLUE_NOISE_SIZE, BLUE_NOISE_SIZE, noise.data(), 1,
+                                             VK_FORMAT_R32_SFLOAT);
+}
+
+void VolumetricCloudSystem::resize(VkExtent2D extent) {
+    destroyImages();
+
+    fullExtent = extent;
+    lowExtent = {std::max((extent.width + resolutionDivisor - 1) / resolutionDivisor, 1u),
+                 std::max((extent.height + resolutionDivisor - 1) / resolutionDivisor, 1u)};
+
+    createStorageImage(VK_FORMAT_R16G16B16A16_SFLOAT, cloudImage);
+    createStorageImage(VK_FORMAT_R32G32_SFLOAT, cloudDepthImage);
+    for (auto &historyImage : historyImages) {
+        createStorageImage(VK_FORMAT_R16G16B16A16_SFLOAT, historyImage);
+    }
+    createDescriptorSets();
+    historyValid = false;
+}
+
+void VolumetricCloudSystem::createStorageImage(VkFormat format, StorageImage &storageImage) {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = lowExtent.width;
+    imageInfo.extent.height = lowExtent.height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    lveDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, storageImage.image,
+                                  storageImage.memory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = storageImage.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &storageImage.view) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create cloud image view!");
+    }
+
+    // les images restent en GENERAL : écrites en storage image, l'historique est aussi lu par sampler
+    VkCommandBuffer commandBuffer = lveDevice.beginSingleTimeCommands();
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = storageImage.image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+    lveDevice.endSingleTimeCommands(commandBuffer);
+}
+
+void VolumetricCloudSystem::createOccupancyGrid() {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_3D;
+    imageInfo.extent.width = OCCUPANCY_GRID_SIZE;
+    imageInfo.extent.height = OCCUPANCY_GRID_SIZE;
+    imageInfo.extent.depth = OCCUPANCY_GRID_SIZE;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = VK_FORMAT_R32_SFLOAT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    lveDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, occupancyGrid.image,
+                                  occupancyGrid.memory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = occupancyGrid.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_3D;
+    viewInfo.format = VK_FORMAT_R32_SFLOAT;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &occupancyGrid.view) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create cloud occupancy grid view!");
+    }
+
+    // NEAREST : interpoler des minorants de cellules voisines ne donnerait plus un minorant
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.compareOp = VK_COMPARE_OP_NEVER;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = 0.0f;
+    samplerInfo.anisotropyEnable = VK_FALSE;
+    samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+    if (vkCreateSampler(lveDevice.device(), &samplerInfo, nullptr, &occupancyGridSampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create cloud occupancy grid sampler!");
+    }
+
+    VkCommandBuffer commandBuffer = lveDevice.beginSingleTimeCommands();
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = occupancyGrid.image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+    lveDevice.endSingleTimeCommands(commandBuffer);
+
+    gridPool = LveDescriptorPool::Builder(lveDevice)
+                   .setMaxSets(1)
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1)
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1)
+                   .build();
+
+    VkDescriptorBufferInfo shapeInfo = cloudShapeBuffer->descriptorInfo();
+    VkDescriptorImageInfo gridInfo{};
+    gridInfo.imageView = occupancyGrid.view;
+    gridInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    LveDescriptorWriter(*gridSetLayout, *gridPool)
+        .writeBuffer(0, &shapeInfo)
+        .writeImage(1, &gridInfo)
+        .build(gridDescriptorSet);
+}
+
+// reconstruit la boîte englobante et la grille d'occupation, seulement après un changement des sphères
+void VolumetricCloudSystem::updateCloudShape(VkCommandBuffer commandBuffer) {
+    CloudShapeUbo shape{};
+    shape.sphereCount = static_cast<int>(cloudSpheres.size());
+    // boîte vide (min > max) sans sphère : tous les rayons la manquent
+    glm::vec3 boundsMin{std::numeric_limits<float>::max()};
+    glm::vec3 boundsMax{std::numeric_limits<float>::lowest()};
+    for (size_t i = 0; i < cloudSpheres.size(); i++) {
+        shape.spheres[i] = cloudSpheres[i];
+        glm::vec3 extent{cloudSpheres[i].w + NOISE_DISPLACEMENT_BOUND};
+        boundsMin = glm::min(boundsMin, glm::vec3(cloudSpheres[i]) - extent);
+        boundsMax = glm::max(boundsMax, glm::vec3(cloudSpheres[i]) + extent);
+    }
+    shape.boundsMin = glm::vec4(boundsMin, NOISE_DISPLACEMENT_BOUND);
+    shape.boundsMax = glm::vec4(boundsMax, 0.f);
+
+    // les frames précédentes ont pu lire la forme et la grille
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0,
+                         nullptr, 0, nullptr);
+
+    vkCmdUpdateBuffer(commandBuffer, cloudShapeBuffer->getBuffer(), 0, sizeof(CloudShapeUbo), &shape);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                         &barrier, 0, nullptr, 0, nullptr);
+
+    gridPipeline->bind(commandBuffer);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, gridPipelineLayout, 0, 1,
+                            &gridDescriptorSet, 0, nullptr);
+    uint32_t groupCount = (OCCUPANCY_GRID_SIZE + 3) / 4;
+    vkCmdDispatch(commandBuffer, groupCount, groupCount, groupCount);
+
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         1, &barrier, 0, nullptr, 0, nullptr);
+
+    cloudShapeDirty = false;
+}
+
+void VolumetricCloudSystem::createDescriptorSets() {
+    cloudPool = LveDescriptorPool::Builder(lveDevice)
+                    .setMaxSets(2)
+                    .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 2 * 4)
+                    .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2 * 3)
+                    .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2)
+                    .build();
+
+    VkDescriptorImageInfo cloudInfo{};
+    cloudInfo.imageView = cloudImage.view;
+    cloudInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    VkDescriptorImageInfo cloudDepthInfo{};
+    cloudDepthInfo.imageView = cloudDepthImage.view;
+    cloudDepthInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    VkDescriptorImageInfo blueNoiseInfo{};
+    blueNoiseInfo.imageView = blueNoise->getImageView();
+    blueNoiseInfo.imageLayout = blueNoise->getImageLayout();
+
+    VkDescriptorImageInfo noiseVolumeInfo = noiseVolume->getDescriptorImageInfo();
+
+    VkDescriptorBufferInfo shapeInfo = cloudShapeBuffer->descriptorInfo();
+
+    VkDescriptorImageInfo occupancyGridInfo{};
+    occupancyGridInfo.sampler = occupancyGridSampler;
+    occupancyGridInfo.imageView = occupancyGrid.view;
+    occupancyGridInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    for (int i = 0; i < 2; i++) {
+        VkDescriptorImageInfo historyInfo{};
+        historyInfo.sampler = historySampler;
+        historyInfo.imageView = historyImages[i].view;
+        historyInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorImageInfo resolvedInfo{};
+        resolvedInfo.imageView = historyImages[1 - i].view;
+        resolvedInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        LveDescriptorWriter(*cloudSetLayout, *cloudPool)
+            .writeImage(0, &cloudInfo)
+            .writeImage(1, &cloudDepthInfo)
+            .writeImage(2, &historyInfo)
+            .writeImage(3, &resolvedInfo)
+            .writeImage(4, &blueNoiseInfo)
+            .writeImage(5, &noiseVolumeInfo)
+            .writeBuffer(6, &shapeInfo)
+            .writeImage(7, &occupancyGridInfo)
+            .build(cloudDescriptorSets[i]);
+    }
+}
+
+void VolumetricCloudSystem::destroyImages() {
+    if (cloudImage.image == VK_NULL_HANDLE) return;
+
+    // les frames en vol peuvent encore lire les anciennes images
+    std::shared_ptr<LveDescriptorPool> pool = std::move(cloudPool);
+    std::vector<StorageImage> storageImages{cloudImage, cloudDepthImage, historyImages[0], historyImages[1]};
+    lveDevice.retire([&device = lveDevice, pool, storageImages]() {
+        for (const StorageImage &storageImage : storageImages) {
+            vkDestroyImageView(device.device(), storageImage.view, nullptr);
+            vkDestroyImage(device.device(), storageImage.image, nullptr);
+            vkFreeMemory(device.device(), storageImage.memory, nullptr);
+        }
+    });
+    for (StorageImage *storageImage : {&cloudImage, &cloudDepthImage, &historyImages[0], &historyImages[1]}) {
+        *storageImage = StorageImage{};
+    }
+}
+
+void VolumetricCloudSystem::executePostCpS(FrameInfo frameInfo, VkDescriptorSet computeDescriptorSets,
+                                           VkDescriptorSet depthDescriptorSets, VkExtent2D extent) {
+    assert(extent.width == fullExtent.width && extent.height == fullExtent.height &&
+           "VolumetricCloudSystem was not resized to the post processing extent");
+    VkCommandBuffer commandBuffer = frameInfo.postProcessingCommandBuffer;
+
+    if (cloudShapeDirty) {
+        updateCloudShape(commandBuffer);
+    }
+
+    VkDescriptorSet descriptorSets[] = {frameInfo.globalDescriptorSet, computeDescriptorSets, depthDescriptorSets,
+                                        cloudDescriptorSets[historyIndex]};
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 4, descriptorSets, 0,
+                            nullptr);
+
+    glm::mat4 viewProjection = frameInfo.camera.getProjection() * frameInfo.camera.getView();
+
+    CloudPushConstantData push{};
+    push.previousViewProjection = previousViewProjection;
+    push.resolution = glm::vec2(extent.width, extent.height);
+    push.lowResolution = glm::vec2(lowExtent.width, lowExtent.height);
+    push.steps = stepCount;
+    push.frameCounter = frameCounter;
+    push.historyWeight = historyValid ? HISTORY_WEIGHT : 0.f;
+    push.bakedNoise = bakedNoise ? 1 : 0;
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CloudPushConstantData),
+                       &push);
+
+    // les images basse résolution sont partagées entre les frames en vol : la frame précédente doit les avoir lues
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         1, &barrier, 0, nullptr, 0, nullptr);
+    marchPipeline->bind(commandBuffer);
+    vkCmdDispatch(commandBuffer, (lowExtent.width + 7) / 8, (lowExtent.height + 7) / 8, 1);
+
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         1, &barrier, 0, nullptr, 0, nullptr);
+    temporalPipeline->bind(commandBuffer);
+    vkCmdDispatch(commandBuffer, (lowExtent.width + 7) / 8, (lowExtent.height + 7) / 8, 1);
+
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         1, &barrier, 0, nullptr, 0, nullptr);
+    upsamplePipeline->bind(commandBuffer);
+    vkCmdDispatch(commandBuffer, (extent.width + 15) / 16, (extent.height + 15) / 16, 1);
+
+    previousViewProjection = viewProjection;
+    historyIndex = 1 - historyIndex;
+    frameCounter++;
+    historyValid = true;
+}
+}  // namespace lve
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../lve_Ipost_processing.hpp"
+#include "lve_buffer.hpp"
+#include "lve_c_pipeline.hpp"
+#include "lve_descriptor.hpp"
+#include "lve_device.hpp"
+#include "lve_frame_info.hpp"
+#include "lve_noise_volume.hpp"
+#include "lve_texture.hpp"
+
+namespace lve {
+/**
+ * Nuages de clouds.comp rendus à résolution réduite : raymarche basse résolution avec un départ décalé par un bruit
+ * bleu, accumulation temporelle reprojetée avec la vue-projection de la frame précédente, puis upsampling bilatéral
+ * guidé par la profondeur vers l'image pleine résolution.
+ */
+class VolumetricCloudSystem : public LveIPostProcessing {
+   public:
+    static constexpr int DEFAULT_STEPS = 200;
+    // 2 : demi résolution, 4 : quart de résolution
+    static constexpr uint32_t DEFAULT_RESOLUTION_DIVISOR = 2;
+    static constexpr uint32_t BLUE_NOISE_SIZE = 64;
+    // part de l'historique dans le mélange temporel
+    static constexpr float HISTORY_WEIGHT = 0.9f;
+    // doit correspondre au tableau spheres de CloudShape dans clouds_march.comp et clouds_grid.comp
+    static constexpr uint32_t MAX_CLOUD_SPHERES = 8;
+    static constexpr uint32_t OCCUPANCY_GRID_SIZE = 32;
+    // majorant du déplacement Noise3D / 3 appliqué dans object(), chaque composante est dans [0, 1 / 3]
+    static constexpr float NOISE_DISPLACEMENT_BOUND = 0.6f;
+
+    VolumetricCloudSystem(LveDevice &device, VkDescriptorSetLayout globalSetLayout,
+                          VkDescriptorSetLayout textureSetLayout, VkDescriptorSetLayout depthSetLayout,
+                          uint32_t resolutionDivisor = DEFAULT_RESOLUTION_DIVISOR);
+    ~VolumetricCloudSystem();
+
+    VolumetricCloudSystem(const VolumetricCloudSystem &) = delete;
+    VolumetricCloudSystem &operator=(const VolumetricCloudSystem &) = delete;
+
+    void executePostCpS(FrameInfo frameInfo, VkDescriptorSet computeDescriptorSets, VkDescriptorSet depthDescriptorSets,
+                        VkExtent2D extent) override;
+    void resize(VkExtent2D extent) override;
+
+    // nombre maximum de pas de la raymarche, réglé par le LvePerformanceGovernor
+    void setStepCount(int steps) { stepCount = steps; }
+    // false : le bruit est recalculé à chaque pas comme dans clouds.comp, pour comparer
+    void setBakedNoise(bool baked) { bakedNoise = baked; }
+    // xyz centre en espace nuage (monde, axes xzy), w rayon. La boîte englobante et la grille d'occupation sont
+    // reconstruites à la frame suivante
+    void setCloudSpheres(const std::vector<glm::vec4> &spheres);
+
+   private:
+    struct StorageImage {
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+    };
+
+    void createBlueNoise();
+    void createStorageImage(VkFormat format, StorageImage &storageImage);
+    void createOccupancyGrid();
+    void updateCloudShape(VkCommandBuffer commandBuffer);
+    void createDescriptorSets();
+    void destroyImages();
+
+    LveDevice &lveDevice;
+    uint32_t resolutionDivisor;
+    int stepCount = DEFAULT_STEPS;
+    bool bakedNoise = true;
+
+    VkExtent2D fullExtent{0, 0};
+    VkExtent2D lowExtent{0, 0};
+    StorageImage cloudImage;       // couleur prémultipliée et transmittance de la frame
+    StorageImage cloudDepthImage;  // distance du nuage, profondeur de la scène
+    std::array<StorageImage, 2> historyImages;
+    VkSampler historySampler = VK_NULL_HANDLE;
+    std::shared_ptr<LveTexture> blueNoise;
+    std::unique_ptr<LveNoiseVolume> noiseVolume;
+
+    std::vector<glm::vec4> cloudSpheres;
+    bool cloudShapeDirty = true;
+    std::unique_ptr<LveBuffer> cloudShapeBuffer;
+    StorageImage occupancyGrid;
+    VkSampler occupancyGridSampler = VK_NULL_HANDLE;
+
+    std::unique_ptr<LveDescriptorSetLayout> cloudSetLayout;
+    std::unique_ptr<LveDescriptorPool> cloudPool;
+    // cloudDescriptorSets[i] lit l'historique i et écrit l'historique 1 - i
+    std::array<VkDescriptorSet, 2> cloudDescriptorSets;
+    std::unique_ptr<LveDescriptorSetLayout> gridSetLayout;
+    std::unique_ptr<LveDescriptorPool> gridPool;
+    VkDescriptorSet gridDescriptorSet;
+
+    uint32_t historyIndex = 0;
+    uint32_t frameCounter = 0;
+    bool historyValid = false;
+    glm::mat4 previousViewProjection{1.f};
+
+    std::unique_ptr<LveCPipeline> marchPipeline;
+    std::unique_ptr<LveCPipeline> temporalPipeline;
+    std::unique_ptr<LveCPipeline> upsamplePipeline;
+    VkPipelineLayout pipelineLayout;
+    std::unique_ptr<LveCPipeline> gridPipeline;
+    VkPipelineLayout gridPipelineLayout;
+};
+}  // namespace lve
@@ -98,14 +98,14 @@ std::vector<float> WaveGen::loadPrecomputeData() {
 }
 
 void WaveGen::createTextures() {
-    spectrumTextureCopy1.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
-    DxDz.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
-    DyDxz.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
-    DyxDyz.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
-    DxxDzz.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
-    displacement.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
-    derivatives.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
-    turbulence.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+    spectrumTextureCopy1.resize(LveSwapChain::getFramesInFlight());
+    DxDz.resize(LveSwapChain::getFramesInFlight());
+    DyDxz.resize(LveSwapChain::getFramesInFlight());
+    DyxDyz.resize(LveSwapChain::getFramesInFlight());
+    DxxDzz.resize(LveSwapChain::getFramesInFlight());
+    displacement.resize(LveSwapChain::getFramesInFlight());
+    derivatives.resize(LveSwapChain::getFramesInFlight());
+    turbulence.resize(LveSwapChain::getFramesInFlight());
 
     spectrumTexture = std::make_shared<LveTexture>(lveDevice, 512, 512, std::vector<uint32_t>(512 * 512 * 2, 0).data(),
                                                    2, VK_FORMAT_R32G32_SFLOAT);
@@ -117,7 +117,7 @@ void WaveGen::createTextures() {
         std::make_shared<LveTexture>(lveDevice, 9, 512, loadPrecomputeData().data(), 4, VK_FORMAT_R32G32B32A32_SFLOAT);
     spectrumConjugateTexture = std::make_shared<LveTexture>(
         lveDevice, 512, 512, std::vector<uint32_t>(512 * 512 * 4, 0).data(), 4, VK_FORMAT_R32G32B32A32_SFLOAT);
-    for (int i = 0; i < LveSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+    for (int i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
         spectrumTextureCopy1[i] = std::make_shared<LveTexture>(
             lveDevice, 512, 512, std::vector<uint32_t>(512 * 512 * 2, 0).data(), 2, VK_FORMAT_R32G32_SFLOAT);
 
@@ -155,6 +155,16 @@ void createPipelineBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags s
 }
 
 void WaveGen::executePreCpS(FrameInfo FrameInfo) {
+    // chaque slot de frame en vol a ses propres textures : on les met à jour à la suite pour qu'elles restent proches
+    uint64_t updateSlot = frameCounter++ / LveSwapChain::getFramesInFlight();
+    skippedTime += FrameInfo.frameTime;
+    if (updateSlot % updateInterval != 0) {
+        return;
+    }
+    // le temps des frames sautées est rattrapé pour ne pas ralentir la houle
+    FrameInfo.frameTime = skippedTime;
+    skippedTime = 0.f;
+
     if (true) {
         // DataIsUpdate = false;
         waveTextureGenerator->executePreCpS(FrameInfo);
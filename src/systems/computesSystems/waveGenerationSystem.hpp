@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -41,6 +43,9 @@ class WaveGen : public LveIPreProcessing {
 
     std::vector<std::shared_ptr<LveTexture>> getAllTurbulence() { return turbulence; }
 
+    // recalcule la cascade une paire de frames en vol sur n, réglé par le LvePerformanceGovernor
+    void setUpdateInterval(int interval) { updateInterval = std::max(interval, 1); }
+
    private:
     void CalculateInitial(FrameInfo FrameInfo);
     void createTextures();
@@ -50,6 +55,10 @@ class WaveGen : public LveIPreProcessing {
 
     bool DataIsUpdate = true;
 
+    int updateInterval = 1;
+    uint64_t frameCounter = 0;
+    float skippedTime = 0.f;
+
     std::vector<float> loadPrecomputeData();
 
     std::shared_ptr<LveTexture> spectrumTexture;
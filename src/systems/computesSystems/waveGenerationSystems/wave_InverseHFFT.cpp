@@ -79,10 +79,10 @@ WaveHorIFFT::~WaveHorIFFT() { vkDestroyPipelineLayout(lveDevice.device(), pipeli
 
 void WaveHorIFFT::createDescriptorPool() {
     wavePool = LveDescriptorPool::Builder(lveDevice)
-                   .setMaxSets(LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
+                   .setMaxSets(LveSwapChain::getFramesInFlight())
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::getFramesInFlight())
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::getFramesInFlight())
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::getFramesInFlight())
                    .build();
 }
 
@@ -95,9 +95,9 @@ void WaveHorIFFT::createDescriptorSetLayout() {
 }
 
 void WaveHorIFFT::createDescriptorSet() {
-    waveConjugateDescriptorSets.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+    waveConjugateDescriptorSets.resize(LveSwapChain::getFramesInFlight());
 
-    for (size_t i = 0; i < LveSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
         VkDescriptorImageInfo bufferDescriptorInfo0{};
         bufferDescriptorInfo0.imageView = buffer0[i]->getImageView();
         bufferDescriptorInfo0.imageLayout = buffer0[i]->getImageLayout();
@@ -72,8 +72,8 @@ WavePermute::~WavePermute() { vkDestroyPipelineLayout(lveDevice.device(), pipeli
 
 void WavePermute::createDescriptorPool() {
     wavePool = LveDescriptorPool::Builder(lveDevice)
-                   .setMaxSets(LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
+                   .setMaxSets(LveSwapChain::getFramesInFlight())
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::getFramesInFlight())
                    .build();
 }
 
@@ -84,9 +84,9 @@ void WavePermute::createDescriptorSetLayout() {
 }
 
 void WavePermute::createDescriptorSet() {
-    waveConjugateDescriptorSets.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+    waveConjugateDescriptorSets.resize(LveSwapChain::getFramesInFlight());
 
-    for (size_t i = 0; i < LveSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
         VkDescriptorImageInfo bufferDescriptorInfo0{};
         bufferDescriptorInfo0.imageView = buffer0[i]->getImageView();
         bufferDescriptorInfo0.imageLayout = buffer0[i]->getImageLayout();
@@ -82,13 +82,13 @@ WaveTimeUpdate::~WaveTimeUpdate() { vkDestroyPipelineLayout(lveDevice.device(),
 
 void WaveTimeUpdate::createDescriptorPool() {
     wavePool = LveDescriptorPool::Builder(lveDevice)
-                   .setMaxSets(LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
+                   .setMaxSets(LveSwapChain::getFramesInFlight())
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::getFramesInFlight())
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::getFramesInFlight())
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::getFramesInFlight())
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::getFramesInFlight())
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::getFramesInFlight())
+                   .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, LveSwapChain::getFramesInFlight())
                    .build();
 }
 
@@ -104,9 +104,9 @@ void WaveTimeUpdate::createDescriptorSetLayout() {
 }
 
 void WaveTimeUpdate::createDescriptorSet() {
-    waveConjugateDescriptorSets.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+    waveConjugateDescriptorSets.resize(LveSwapChain::getFramesInFlight());
 
-    for (size_t i = 0; i < LveSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
         VkDescriptorImageInfo Dx_DzDesc{};
         Dx_DzDesc.imageView = Dx_Dz[i]->getImageView();
         Dx_DzDesc.imageLayout = Dx_Dz[i]->getImageLayout();
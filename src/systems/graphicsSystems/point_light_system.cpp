@@ -8,31 +8,46 @@
 #include "../pipeline_builder.hpp"
 #include "lve_device.hpp"
 #include "lve_frame_info.hpp"
+#include "lve_swap_chain.hpp"
 #include "lve_utils.hpp"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstring>
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
-#include <map>
 #include <stdexcept>
 
 namespace lve {
 
-struct PointLightPushConstants {
-    glm::vec4 position{};
-    glm::vec4 color{};
-    float radius;
+// doit correspondre à LightSprite dans point_light.vert (std430)
+struct LightSprite {
+    glm::vec4 position{};  // w is radius
+    glm::vec4 color{};     // w is intensity
 };
 
-PointLightSystem::PointLightSystem(LveDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout)
-    : lveDevice{device} {
+static constexpr uint32_t INITIAL_SPRITE_CAPACITY = 64;
+
+// intensité en dessous de laquelle une lumière est ignorée par le clustering
+static constexpr float LIGHT_CUTOFF = 1.f / 256.f;
+
+PointLightSystem::PointLightSystem(LveDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout,
+                                   std::shared_ptr<LightCullingSystem> lightCullingSystem)
+    : lveDevice{device}, lightCullingSystem{lightCullingSystem} {
+    spriteBuffers.resize(LveSwapChain::getFramesInFlight());
+    for (int i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
+        createSpriteBuffer(i, INITIAL_SPRITE_CAPACITY);
+    }
+    createDescriptorSets();
+
     PipelineCreateInfo pipelineCreateInfo{device,
                                           LvePipeLineType::LvePipeLineTypeRender,
-                                          {globalSetLayout},
+                                          {globalSetLayout, spriteSetLayout->getDescriptorSetLayout()},
                                           {"shaders/point_light.vert.spv", "shaders/point_light.frag.spv"},
-                                          sizeof(PointLightPushConstants),
+                                          0,
                                           LvePipelIneFunctionnality::Transparancy,
                                           renderPass};
 
@@ -43,8 +58,33 @@ PointLightSystem::PointLightSystem(LveDevice &device, VkRenderPass renderPass, V
 
 PointLightSystem::~PointLightSystem() { vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr); }
 
+void PointLightSystem::createSpriteBuffer(int frameIndex, uint32_t capacity) {
+    spriteBuffers[frameIndex] = std::make_unique<LveBuffer>(lveDevice, sizeof(LightSprite), capacity,
+                                                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+    spriteBuffers[frameIndex]->map();
+}
+
+void PointLightSystem::createDescriptorSets() {
+    spritePool = LveDescriptorPool::Builder(lveDevice)
+                     .setMaxSets(LveSwapChain::getFramesInFlight())
+                     .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, LveSwapChain::getFramesInFlight())
+                     .build();
+
+    spriteSetLayout = LveDescriptorSetLayout::Builder(lveDevice)
+                          .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
+                          .build();
+
+    spriteDescriptorSets.resize(LveSwapChain::getFramesInFlight());
+    for (int i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
+        auto spriteInfo = spriteBuffers[i]->descriptorInfo();
+        LveDescriptorWriter(*spriteSetLayout, *spritePool).writeBuffer(0, &spriteInfo).build(spriteDescriptorSets[i]);
+    }
+}
+
 void PointLightSystem::update(FrameInfo &frameInfo, GlobalUbo &ubo) {
     int lightIndex = 0;
+    lights.clear();
 
     auto rotateLight = glm::rotate(glm::mat4(1.f), frameInfo.frameTime * 1, {0.f, -1.f, 0.f});
     float speed = 1.0f;
@@ -59,47 +99,97 @@ void PointLightSystem::update(FrameInfo &frameInfo, GlobalUbo &ubo) {
         glm::vec3 rgb = glm::vec3(r, g, b);
         obj.color = rgb;
 
-        assert(lightIndex < MAX_LIGHTS && "Point light exceed maximum specified");
-
         // update light position
         obj.transform.translation = glm::vec3(rotateLight * glm::vec4(obj.transform.translation, 1.f));
 
-        // copy light position
-        ubo.pointLights[lightIndex].position = glm::vec4(obj.transform.translation, 1.f);
-        ubo.pointLights[lightIndex].color = glm::vec4(obj.color, obj.pointLight->lightIntensity);
+        // copy light position, la portée est la distance où l'atténuation en 1/d² passe sous LIGHT_CUTOFF
+        float maxIntensity = obj.pointLight->lightIntensity * std::max(obj.color.r, std::max(obj.color.g, obj.color.b));
+        float range = std::sqrt(maxIntensity / LIGHT_CUTOFF);
+        lights.push_back({glm::vec4(obj.transform.translation, range), glm::vec4(obj.color, obj.pointLight->lightIntensity)});
         lightIndex += 1;
     }
     ubo.numLights = lightIndex;
+    lightCullingSystem->writeLights(frameInfo.frameIndex, lights);
     time += 0.01;
 }
 
-void PointLightSystem::render(FrameInfo &frameInfo) {
-    std::map<float, LveGameObject::id_t> sorted;
+// tri par base 256 (LSD, 4 passes) : les distances sont positives, leurs bits sont donc ordonnés comme les floats.
+// Les clés sont inversées pour obtenir un ordre du plus loin au plus proche, les égalités sont conservées.
+void PointLightSystem::sortBackToFront() {
+    size_t count = sortKeys.size();
+    sortKeysTmp.resize(count);
+    sortIndicesTmp.resize(count);
+
+    for (uint32_t shift = 0; shift < 32; shift += 8) {
+        std::array<uint32_t, 257> offsets{};
+        for (size_t i = 0; i < count; i++) {
+            offsets[((sortKeys[i] >> shift) & 0xFF) + 1]++;
+        }
+        for (size_t bucket = 1; bucket < offsets.size(); bucket++) {
+            offsets[bucket] += offsets[bucket - 1];
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint32_t destination = offsets[(sortKeys[i] >> shift) & 0xFF]++;
+            sortKeysTmp[destination] = sortKeys[i];
+            sortIndicesTmp[destination] = sortIndices[i];
+        }
+        sortKeys.swap(sortKeysTmp);
+        sortIndices.swap(sortIndicesTmp);
+    }
+}
+
+void PointLightSystem::submit(FrameInfo &frameInfo, LveRenderQueue &renderQueue) {
+    float farthestDisSquared = 0.f;
+    spriteObjects.clear();
+    sortKeys.clear();
+    sortIndices.clear();
     for (auto &kv : frameInfo.gameObjects) {
         auto &obj = kv.second;
         if (obj.pointLight == nullptr) continue;
         auto offset = frameInfo.camera.getPosition() - obj.transform.translation;
         float disSquared = glm::dot(offset, offset);
-        sorted[disSquared] = obj.getId();
+        farthestDisSquared = std::max(farthestDisSquared, disSquared);
+        uint32_t key;
+        std::memcpy(&key, &disSquared, sizeof(key));
+        sortKeys.push_back(~key);
+        sortIndices.push_back(static_cast<uint32_t>(spriteObjects.size()));
+        spriteObjects.push_back(&obj);
+    }
+    if (spriteObjects.empty()) return;
+    sortBackToFront();
+
+    // le buffer de cette frame n'est plus utilisé par le GPU, on peut le remplacer
+    uint32_t spriteCount = static_cast<uint32_t>(spriteObjects.size());
+    auto &spriteBuffer = spriteBuffers[frameInfo.frameIndex];
+    if (spriteCount > spriteBuffer->getInstanceCount()) {
+        createSpriteBuffer(frameInfo.frameIndex, std::max(spriteCount, spriteBuffer->getInstanceCount() * 2));
+        auto spriteInfo = spriteBuffer->descriptorInfo();
+        LveDescriptorWriter(*spriteSetLayout, *spritePool)
+            .writeBuffer(0, &spriteInfo)
+            .overwrite(spriteDescriptorSets[frameInfo.frameIndex]);
     }
 
-    lveGPipeline->bind(frameInfo.commandBuffer);
-
-    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
-                            &frameInfo.globalDescriptorSet, 0, nullptr);
-
-    for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
-        auto &obj = frameInfo.gameObjects.at(it->second);
-
-        PointLightPushConstants push{};
-        push.position = glm::vec4(obj.transform.translation, 1.f);
-        push.color = glm::vec4(obj.color, obj.pointLight->lightIntensity);
-        push.radius = obj.transform.scale.x;
-        vkCmdPushConstants(frameInfo.commandBuffer, pipelineLayout,
-                           VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
-                           sizeof(PointLightPushConstants), &push);
-        vkCmdDraw(frameInfo.commandBuffer, 6, 1, 0, 0);
+    auto *sprites = static_cast<LightSprite *>(spriteBuffer->getMappedMemory());
+    for (uint32_t i = 0; i < spriteCount; i++) {
+        const LveGameObject &obj = *spriteObjects[sortIndices[i]];
+        sprites[i].position = glm::vec4(obj.transform.translation, obj.transform.scale.x);
+        sprites[i].color = glm::vec4(obj.color, obj.pointLight->lightIntensity);
     }
+    spriteBuffer->flush();
+
+    // le paquet est placé parmi les transparents selon le billboard le plus lointain
+    DrawPacket packet{};
+    packet.sortKey = LveRenderQueue::makeTransparentKey(renderQueue.getPipelineId(lveGPipeline.get()), 0,
+                                                        std::sqrt(farthestDisSquared));
+    packet.pipeline = lveGPipeline.get();
+    packet.pipelineLayout = pipelineLayout;
+    packet.descriptorSetCount = 2;
+    packet.descriptorSets = {frameInfo.globalDescriptorSet, spriteDescriptorSets[frameInfo.frameIndex]};
+    packet.draw = [spriteCount](VkCommandBuffer commandBuffer) {
+        // un billboard par instance, dans l'ordre du buffer
+        vkCmdDraw(commandBuffer, 6, spriteCount, 0, 0);
+    };
+    renderQueue.submit(std::move(packet));
 }
 
-}  // namespace lve
\ No newline at end of file
+}  // namespace lve
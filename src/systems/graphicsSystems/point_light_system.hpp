@@ -5,23 +5,47 @@
 #include <memory>
 #include <vector>
 
+#include "lve_buffer.hpp"
+#include "lve_descriptor.hpp"
 #include "lve_device.hpp"
 #include "lve_frame_info.hpp"
 #include "lve_g_pipeline.hpp"
+#include "lve_render_queue.hpp"
+#include "systems/computesSystems/lightCullingSystem.hpp"
 namespace lve {
 class PointLightSystem {
    public:
-    PointLightSystem(LveDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
+    PointLightSystem(LveDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout,
+                     std::shared_ptr<LightCullingSystem> lightCullingSystem);
     ~PointLightSystem();
 
     PointLightSystem(const LveWindow &) = delete;
     PointLightSystem &operator=(const LveWindow &) = delete;
 
     void update(FrameInfo &frameInfo, GlobalUbo &ubo);
-    void render(FrameInfo &frameInfo);
+    // trie et écrit les billboards puis soumet un seul paquet instancié avec les transparents
+    void submit(FrameInfo &frameInfo, LveRenderQueue &renderQueue);
 
    private:
+    void createSpriteBuffer(int frameIndex, uint32_t capacity);
+    void createDescriptorSets();
+    void sortBackToFront();
+
     float time;
+    std::vector<PointLight> lights;
+    std::shared_ptr<LightCullingSystem> lightCullingSystem;
+
+    // mémoire réutilisée d'une frame à l'autre pour le tri des billboards
+    std::vector<uint32_t> sortKeys;
+    std::vector<uint32_t> sortKeysTmp;
+    std::vector<uint32_t> sortIndices;
+    std::vector<uint32_t> sortIndicesTmp;
+    std::vector<LveGameObject *> spriteObjects;
+
+    std::vector<std::unique_ptr<LveBuffer>> spriteBuffers;
+    std::unique_ptr<LveDescriptorPool> spritePool;
+    std::unique_ptr<LveDescriptorSetLayout> spriteSetLayout;
+    std::vector<VkDescriptorSet> spriteDescriptorSets;
     LveDevice &lveDevice;
     std::unique_ptr<LveGPipeline> lveGPipeline;
     VkPipelineLayout pipelineLayout;
@@ -20,54 +20,72 @@
 
 namespace lve {
 
-struct SimplePushConstantData {
-    glm::mat4 modelMatrix{1.f};
-    glm::mat4 normalMatrix{1.f};
-};
-
 SimpleRenderSystem::SimpleRenderSystem(LveDevice &device, VkRenderPass renderPass,
-                                       VkDescriptorSetLayout globalSetLayout, VkDescriptorSetLayout textureSetLayout,
+                                       VkDescriptorSetLayout globalSetLayout,
+                                       std::shared_ptr<LveTextureTable> textureTable,
                                        std::shared_ptr<LveDescriptorSetLayout> waveLayout,
-                                       std::vector<VkDescriptorSet> waterSets)
-    : lveDevice{device}, waterSets{waterSets} {
+                                       std::vector<VkDescriptorSet> waterSets,
+                                       std::shared_ptr<CullingSystem> cullingSystem,
+                                       std::shared_ptr<LightCullingSystem> lightCullingSystem)
+    : lveDevice{device},
+      textureTable{textureTable},
+      waterSets{waterSets},
+      cullingSystem{cullingSystem},
+      lightCullingSystem{lightCullingSystem} {
     PipelineCreateInfo pipelineCreateInfo{device,
                                           LvePipeLineType::LvePipeLineTypeRender,
-                                          {globalSetLayout, textureSetLayout, waveLayout->getDescriptorSetLayout()},
+                                          {globalSetLayout, textureTable->getDescriptorSetLayout(), waveLayout->getDescriptorSetLayout(),
+                                           cullingSystem->getDescriptorSetLayout(),
+                                           lightCullingSystem->getDescriptorSetLayout()},
                                           {"shaders/simple_shader.vert.spv", "shaders/simple_shader.frag.spv"},
-                                          sizeof(SimplePushConstantData),
+                                          0,
                                           LvePipelIneFunctionnality::None,
                                           renderPass};
 
     pipelineLayout = PipelineBuilder::BuildPipeLineLayout(pipelineCreateInfo);
-    lveGPipeline = PipelineBuilder::BuildGraphicsPipeline(pipelineCreateInfo, pipelineLayout);
+    for (uint32_t format = 0; format < lveGPipelines.size(); format++) {
+        pipelineCreateInfo.vertexFormat = static_cast<LveVertexFormat>(format);
+        lveGPipelines[format] = PipelineBuilder::BuildGraphicsPipeline(pipelineCreateInfo, pipelineLayout);
+    }
 }
 SimpleRenderSystem::~SimpleRenderSystem() { vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr); }
 
-void SimpleRenderSystem::renderGameObjects(FrameInfo &frameInfo) {
-    lveGPipeline->bind(frameInfo.commandBuffer);
-
-    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
-                            &frameInfo.globalDescriptorSet, 0, nullptr);
+void SimpleRenderSystem::submit(FrameInfo &frameInfo, CullingPhase phase, LveRenderQueue &renderQueue) {
+    // toutes les textures des objets sont dans la table : les batches ne diffèrent que par leur vertex buffer
+    std::array<VkDescriptorSet, 6> descriptorSets{frameInfo.globalDescriptorSet, textureTable->getDescriptorSet(),
+                                                  waterSets[frameInfo.frameIndex],
+                                                  cullingSystem->getDescriptorSet(frameInfo.frameIndex),
+                                                  lightCullingSystem->getDescriptorSet(frameInfo.frameIndex)};
 
-    for (auto &kv : frameInfo.gameObjects) {
-        auto &obj = kv.second;
-        if (obj.model == nullptr || obj.water != nullptr) continue;
+    // une draw list compactée par modèle et par phase, écrite par CullingSystem
+    VkBuffer drawBuffer = cullingSystem->getDrawCommandBuffer(frameInfo.frameIndex);
+    VkBuffer countBuffer = cullingSystem->getDrawCountBuffer(frameInfo.frameIndex);
+    VkDeviceSize commandOffset = cullingSystem->getDrawCommandOffset(phase);
+    VkDeviceSize countOffset = cullingSystem->getDrawCountOffset(phase);
+    const auto &batches = cullingSystem->getBatches();
+    for (uint32_t batchIndex = 0; batchIndex < batches.size(); batchIndex++) {
+        const auto &batch = batches[batchIndex];
+        LveModel *model = batch.model.get();
+        LveGPipeline *pipeline = lveGPipelines[model->getVertexFormat()].get();
+        VkDeviceSize drawOffset = commandOffset + batch.firstCommand * sizeof(VkDrawIndexedIndirectCommand);
+        VkDeviceSize drawCountOffset = countOffset + batchIndex * sizeof(uint32_t);
+        uint32_t maxDrawCount = batch.maxDrawCount;
 
-        if (obj.texture != nullptr) {
-            vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1,
-                                    &obj.model->textureDescriptorSet, 0, nullptr);
-        }
-        vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 2, 1,
-                                &waterSets[frameInfo.frameIndex], 0, nullptr);
-        SimplePushConstantData push{};
-        push.modelMatrix = obj.transform.mat4();
-        push.normalMatrix = obj.transform.normalMatrix();
-        vkCmdPushConstants(frameInfo.commandBuffer, pipelineLayout,
-                           VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(SimplePushConstantData),
-                           &push);
-        obj.model->bind(frameInfo.commandBuffer);
-        obj.model->draw(frameInfo.commandBuffer);
+        // pas de matériau : les textures passent par la table, la profondeur ordonne les batches d'un même pipeline
+        DrawPacket packet{};
+        packet.sortKey = LveRenderQueue::makeOpaqueKey(RenderLayerOpaque, renderQueue.getPipelineId(pipeline), 0,
+                                                       batch.nearestDistance);
+        packet.pipeline = pipeline;
+        packet.pipelineLayout = pipelineLayout;
+        packet.descriptorSetCount = 5;
+        packet.descriptorSets = descriptorSets;
+        packet.model = model;
+        packet.draw = [model, drawBuffer, drawOffset, countBuffer, drawCountOffset,
+                       maxDrawCount](VkCommandBuffer commandBuffer) {
+            model->drawIndirect(commandBuffer, drawBuffer, drawOffset, countBuffer, drawCountOffset, maxDrawCount);
+        };
+        renderQueue.submit(std::move(packet));
     }
 }
 
-}  // namespace lve
\ No newline at end of file
+}  // namespace lve
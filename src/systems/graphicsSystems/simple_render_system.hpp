@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -9,23 +10,33 @@
 #include "lve_device.hpp"
 #include "lve_frame_info.hpp"
 #include "lve_g_pipeline.hpp"
+#include "lve_render_queue.hpp"
+#include "lve_texture_table.hpp"
+#include "systems/computesSystems/cullingSystem.hpp"
+#include "systems/computesSystems/lightCullingSystem.hpp"
 namespace lve {
 class SimpleRenderSystem {
    public:
     SimpleRenderSystem(LveDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout,
-                       VkDescriptorSetLayout textureSetLayout, std::shared_ptr<LveDescriptorSetLayout> waveLayout,
-                       std::vector<VkDescriptorSet> waterSets);
+                       std::shared_ptr<LveTextureTable> textureTable, std::shared_ptr<LveDescriptorSetLayout> waveLayout,
+                       std::vector<VkDescriptorSet> waterSets, std::shared_ptr<CullingSystem> cullingSystem,
+                       std::shared_ptr<LightCullingSystem> lightCullingSystem);
     ~SimpleRenderSystem();
 
     SimpleRenderSystem(const LveWindow &) = delete;
     SimpleRenderSystem &operator=(const LveWindow &) = delete;
 
-    void renderGameObjects(FrameInfo &frameInfo);
+    // soumet un paquet par draw list écrite par la phase de culling donnée
+    void submit(FrameInfo &frameInfo, CullingPhase phase, LveRenderQueue &renderQueue);
 
    private:
+    std::shared_ptr<LveTextureTable> textureTable;
     std::vector<VkDescriptorSet> waterSets;
+    std::shared_ptr<CullingSystem> cullingSystem;
+    std::shared_ptr<LightCullingSystem> lightCullingSystem;
     LveDevice &lveDevice;
-    std::unique_ptr<LveGPipeline> lveGPipeline;
+    // une variante par LveVertexFormat, même layout
+    std::array<std::unique_ptr<LveGPipeline>, 3> lveGPipelines;
     VkPipelineLayout pipelineLayout;
 };
 }  // namespace lve
\ No newline at end of file
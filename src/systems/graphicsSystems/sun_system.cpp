@@ -71,20 +71,26 @@ void SunSystem::createDescriptorSet() {
 
 void SunSystem::loadSunTexture() { sunTexture = std::make_shared<LveTexture>(lveDevice, "textures/sun.png", false); }
 
-void SunSystem::render(FrameInfo& frameInfo) {
-    lveGPipeline->bind(frameInfo.commandBuffer);
-    VkDescriptorSet descriptorSet[] = {frameInfo.globalDescriptorSet, sunDescriptorSets};
-    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 2,
-                            descriptorSet, 0, nullptr);
-
+void SunSystem::submit(FrameInfo& frameInfo, LveRenderQueue& renderQueue) {
     PointLightPushConstants push{};
     push.position = glm::vec4(sun->transform.translation, 1.f);
     push.radius = sun->transform.scale.x;
-    vkCmdPushConstants(frameInfo.commandBuffer, pipelineLayout,
-                       VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PointLightPushConstants),
-                       &push);
-
-    vkCmdDraw(frameInfo.commandBuffer, 6, 1, 0, 0);
+    VkPipelineLayout layout = pipelineLayout;
+
+    DrawPacket packet{};
+    packet.sortKey = LveRenderQueue::makeTransparentKey(
+        renderQueue.getPipelineId(lveGPipeline.get()), 0,
+        glm::length(sun->transform.translation - frameInfo.camera.getPosition()));
+    packet.pipeline = lveGPipeline.get();
+    packet.pipelineLayout = pipelineLayout;
+    packet.descriptorSetCount = 2;
+    packet.descriptorSets = {frameInfo.globalDescriptorSet, sunDescriptorSets};
+    packet.draw = [layout, push](VkCommandBuffer commandBuffer) {
+        vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                           sizeof(PointLightPushConstants), &push);
+        vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+    };
+    renderQueue.submit(std::move(packet));
 }
 
 }  // namespace lve
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "lve_frame_info.hpp"
 #include "lve_g_pipeline.hpp"
 #include "lve_game_object.hpp"
+#include "lve_render_queue.hpp"
 namespace lve {
 class SunSystem {
    public:
@@ -20,7 +21,7 @@ class SunSystem {
     SunSystem &operator=(const LveWindow &) = delete;
 
     void update(FrameInfo &frameInfo, GlobalUbo &ubo);
-    void render(FrameInfo &frameInfo);
+    void submit(FrameInfo &frameInfo, LveRenderQueue &renderQueue);
 
    private:
     void createDescriptorPool();
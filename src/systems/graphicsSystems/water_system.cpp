@@ -13,6 +13,7 @@
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <array>
+#include <cassert>
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 #include <iostream>
@@ -35,8 +36,11 @@ WaterSystem::WaterSystem(LveDevice &device, VkRenderPass renderPass, VkDescripto
                          std::vector<std::shared_ptr<LveTexture>> turbulenceTexture2,
                          std::vector<std::shared_ptr<LveTexture>> displacementTexture3,
                          std::vector<std::shared_ptr<LveTexture>> derivateTexture3,
-                         std::vector<std::shared_ptr<LveTexture>> turbulenceTexture3)
-    : lveDevice{device} {
+                         std::vector<std::shared_ptr<LveTexture>> turbulenceTexture3,
+                         std::shared_ptr<LightCullingSystem> lightCullingSystem)
+    : lveDevice{device}, lightCullingSystem{lightCullingSystem} {
+    createClipmapIndexBuffer();
+    createClipmapBuffers();
     createDescriptorSetLayout();
     createDescriptorPool();
     ceateDescriptorSet(displacementTexture1, derivateTexture1, turbulenceTexture1, displacementTexture2,
@@ -44,17 +48,122 @@ WaterSystem::WaterSystem(LveDevice &device, VkRenderPass renderPass, VkDescripto
                        turbulenceTexture3);
     PipelineCreateInfo pipelineCreateInfo{device,
                                           LvePipeLineType::LvePipeLineTypeRender,
-                                          {globalSetLayout, waterTextureSetLayout->getDescriptorSetLayout()},
+                                          {globalSetLayout, waterTextureSetLayout->getDescriptorSetLayout(),
+                                           lightCullingSystem->getDescriptorSetLayout()},
                                           {"shaders/water.vert.spv", "shaders/water.frag.spv"},
                                           sizeof(SimplePushConstantData),
-                                          LvePipelIneFunctionnality::None,
+                                          LvePipelIneFunctionnality::NoVertexInput,
                                           renderPass};
 
     pipelineLayout = PipelineBuilder::BuildPipeLineLayout(pipelineCreateInfo);
     lveGPipeline = PipelineBuilder::BuildGraphicsPipeline(pipelineCreateInfo, pipelineLayout);
+
+    pipelineCreateInfo.shaderPaths = {"shaders/water_far.vert.spv", "shaders/water_far.frag.spv"};
+    farFieldPipeline = PipelineBuilder::BuildGraphicsPipeline(pipelineCreateInfo, pipelineLayout);
 }
 WaterSystem::~WaterSystem() { vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr); }
 
+void WaterSystem::createClipmapIndexBuffer() {
+    static_assert((CLIPMAP_GRID_SIZE + 1) * (CLIPMAP_GRID_SIZE + 1) <= 0x10000, "Clipmap grid must fit 16-bit indices");
+    constexpr uint32_t rowStride = CLIPMAP_GRID_SIZE + 1;
+
+    std::vector<uint16_t> indices;
+    // deux triangles par quad
+    auto addQuad = [&indices](uint32_t x, uint32_t y) {
+        uint16_t v00 = static_cast<uint16_t>(y * rowStride + x);
+        uint16_t v01 = static_cast<uint16_t>(v00 + rowStride);
+        uint16_t v10 = static_cast<uint16_t>(v00 + 1);
+        uint16_t v11 = static_cast<uint16_t>(v01 + 1);
+        indices.insert(indices.end(), {v00, v01, v10, v10, v01, v11});
+    };
+
+    // grille complète ligne par ligne : ses h premières lignes servent aux bandes haute et basse des anneaux
+    for (uint32_t y = 0; y < CLIPMAP_GRID_SIZE; y++) {
+        for (uint32_t x = 0; x < CLIPMAP_GRID_SIZE; x++) {
+            addQuad(x, y);
+        }
+    }
+    // bloc de la hauteur du trou colonne par colonne : ses w premières colonnes servent aux bandes gauche et droite
+    sideBlockFirstIndex = static_cast<uint32_t>(indices.size());
+    for (uint32_t x = 0; x < CLIPMAP_GRID_SIZE / 4 + 1; x++) {
+        for (uint32_t y = 0; y < CLIPMAP_GRID_SIZE / 2; y++) {
+            addQuad(x, y);
+        }
+    }
+
+    LveBuffer stagingBuffer{
+        lveDevice,
+        sizeof(indices[0]),
+        static_cast<uint32_t>(indices.size()),
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+    };
+    stagingBuffer.map();
+    stagingBuffer.writeToBuffer(indices.data());
+
+    clipmapIndexBuffer = std::make_unique<LveBuffer>(
+        lveDevice, sizeof(indices[0]), static_cast<uint32_t>(indices.size()),
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    lveDevice.copyBuffer(stagingBuffer.getBuffer(), clipmapIndexBuffer->getBuffer(),
+                         sizeof(indices[0]) * indices.size());
+}
+
+void WaterSystem::createClipmapBuffers() {
+    clipmapBuffers.resize(LveSwapChain::getFramesInFlight());
+    for (auto &buffer : clipmapBuffers) {
+        buffer = std::make_unique<LveBuffer>(lveDevice, sizeof(glm::ivec4) * CLIPMAP_LEVELS, 1,
+                                             VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+        buffer->map();
+    }
+}
+
+WaterSystem::ClipmapDraws WaterSystem::updateClipmap(FrameInfo &frameInfo) {
+    constexpr int32_t gridSize = CLIPMAP_GRID_SIZE;
+    constexpr int32_t rowStride = CLIPMAP_GRID_SIZE + 1;
+    constexpr int32_t holeSize = CLIPMAP_GRID_SIZE / 2;
+
+    // l'océan est rendu à l'échelle 1/2 : la caméra est à 2x sa position dans la grille
+    glm::vec3 cameraPosition = frameInfo.camera.getPosition();
+    glm::vec2 cameraCell = glm::vec2{cameraPosition.x, cameraPosition.z} * 2.f / CLIPMAP_BASE_SPACING;
+
+    // origine de chaque niveau en multiples de l'espacement de base, calculée une seule fois ici pour que les blocs
+    // de l'anneau et le shader s'accordent sur la position du trou
+    std::array<glm::ivec4, CLIPMAP_LEVELS> origins{};
+    for (uint32_t level = 0; level < CLIPMAP_LEVELS; level++) {
+        int32_t step = 1 << level;
+        // centre aligné sur 2x l'espacement du niveau pour que les vertex ne glissent pas quand la caméra bouge et
+        // que le bord tombe sur la grille du niveau suivant
+        glm::ivec2 center = glm::ivec2{glm::floor(cameraCell / static_cast<float>(2 * step) + 0.5f)} * (2 * step);
+        origins[level] = glm::ivec4{center - gridSize / 2 * step, 0, 0};
+    }
+    clipmapBuffers[frameInfo.frameIndex]->writeToBuffer(origins.data());
+    clipmapBuffers[frameInfo.frameIndex]->flush();
+
+    ClipmapDraws draws{};
+    size_t drawCount = 0;
+    auto addDraw = [&draws, &drawCount](int32_t indexCount, uint32_t firstIndex, int32_t vertexOffset,
+                                        uint32_t level) {
+        draws[drawCount++] = {static_cast<uint32_t>(indexCount), firstIndex, vertexOffset, level};
+    };
+    addDraw(gridSize * gridSize * 6, 0, 0, 0);
+    for (uint32_t level = 1; level < CLIPMAP_LEVELS; level++) {
+        int32_t step = 1 << level;
+        // coin du trou couvert par le niveau plus fin, en quads du niveau : gridSize / 4 à un quad près selon
+        // l'alignement des deux centres
+        glm::ivec2 hole = (glm::ivec2{origins[level - 1]} - glm::ivec2{origins[level]}) / step;
+        assert(hole.x >= gridSize / 4 - 1 && hole.x <= gridSize / 4 + 1 && "Clipmap hole outside the side block");
+        assert(hole.y >= gridSize / 4 - 1 && hole.y <= gridSize / 4 + 1 && "Clipmap hole outside the side block");
+
+        // bandes basse et haute sur toute la largeur, bandes gauche et droite sur la hauteur du trou
+        addDraw(hole.y * gridSize * 6, 0, 0, level);
+        addDraw((gridSize - hole.y - holeSize) * gridSize * 6, 0, (hole.y + holeSize) * rowStride, level);
+        addDraw(hole.x * holeSize * 6, sideBlockFirstIndex, hole.y * rowStride, level);
+        addDraw((gridSize - hole.x - holeSize) * holeSize * 6, sideBlockFirstIndex,
+                hole.y * rowStride + hole.x + holeSize, level);
+    }
+    return draws;
+}
+
 void WaterSystem::createDescriptorSetLayout() {
     waterTextureSetLayout = LveDescriptorSetLayout::Builder(lveDevice)
                                 .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
@@ -75,21 +184,23 @@ void WaterSystem::createDescriptorSetLayout() {
                                             VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT)
                                 .addBinding(8, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
                                             VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT)
+                                .addBinding(9, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
                                 .build();
 }
 
 void WaterSystem::createDescriptorPool() {
     TexturePool = LveDescriptorPool::Builder(lveDevice)
-                      .setMaxSets(LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
+                      .setMaxSets(LveSwapChain::getFramesInFlight())
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::getFramesInFlight())
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::getFramesInFlight())
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::getFramesInFlight())
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::getFramesInFlight())
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::getFramesInFlight())
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::getFramesInFlight())
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::getFramesInFlight())
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::getFramesInFlight())
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::getFramesInFlight())
+                      .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, LveSwapChain::getFramesInFlight())
                       .build();
 }
 
@@ -102,8 +213,8 @@ void WaterSystem::ceateDescriptorSet(std::vector<std::shared_ptr<LveTexture>> di
                                      std::vector<std::shared_ptr<LveTexture>> displacementTexture3,
                                      std::vector<std::shared_ptr<LveTexture>> derivateTexture3,
                                      std::vector<std::shared_ptr<LveTexture>> turbulenceTexture3) {
-    for (int i = 0; i < LveSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
-        descriptorSets.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+    for (int i = 0; i < LveSwapChain::getFramesInFlight(); i++) {
+        descriptorSets.resize(LveSwapChain::getFramesInFlight());
 
         VkDescriptorImageInfo displacementDescriptorInfo{};
         displacementDescriptorInfo.imageView = displacementTexture1[i]->getImageView();
@@ -150,6 +261,8 @@ void WaterSystem::ceateDescriptorSet(std::vector<std::shared_ptr<LveTexture>> di
         turbulenceDescriptorInfo3.imageLayout = turbulenceTexture3[i]->getImageLayout();
         turbulenceDescriptorInfo3.sampler = turbulenceTexture3[i]->getSampler();
 
+        VkDescriptorBufferInfo clipmapBufferInfo = clipmapBuffers[i]->descriptorInfo();
+
         LveDescriptorWriter(*waterTextureSetLayout, *TexturePool)
             .writeImage(0, &displacementDescriptorInfo)
             .writeImage(1, &derivateDescriptorInfo)
@@ -160,32 +273,59 @@ void WaterSystem::ceateDescriptorSet(std::vector<std::shared_ptr<LveTexture>> di
             .writeImage(6, &displacementDescriptorInfo3)
             .writeImage(7, &derivateDescriptorInfo3)
             .writeImage(8, &turbulenceDescriptorInfo3)
+            .writeBuffer(9, &clipmapBufferInfo)
             .build(descriptorSets[i]);
     }
 }
 
-void WaterSystem::renderGameObjects(FrameInfo &frameInfo) {
-    lveGPipeline->bind(frameInfo.commandBuffer);
-
-    vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
-                            &frameInfo.globalDescriptorSet, 0, nullptr);
+void WaterSystem::submit(FrameInfo &frameInfo, LveRenderQueue &renderQueue) {
+    uint16_t pipelineId = renderQueue.getPipelineId(lveGPipeline.get());
+    uint16_t farFieldPipelineId = renderQueue.getPipelineId(farFieldPipeline.get());
+    std::array<VkDescriptorSet, 6> waterDescriptorSets{frameInfo.globalDescriptorSet,
+                                                       descriptorSets[frameInfo.frameIndex],
+                                                       lightCullingSystem->getDescriptorSet(frameInfo.frameIndex)};
+    ClipmapDraws clipmapDraws = updateClipmap(frameInfo);
+    VkBuffer clipmapIndices = clipmapIndexBuffer->getBuffer();
 
     for (auto &kv : frameInfo.gameObjects) {
         auto &obj = kv.second;
         if (obj.water == nullptr) continue;
 
-        vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1,
-                                &descriptorSets[frameInfo.frameIndex], 0, nullptr);
-
         SimplePushConstantData push{};
         push.modelMatrix = obj.transform.mat4();
         push.normalMatrix = obj.transform.normalMatrix();
-        vkCmdPushConstants(frameInfo.commandBuffer, pipelineLayout,
-                           VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(SimplePushConstantData),
-                           &push);
-        obj.model->bind(frameInfo.commandBuffer);
-        obj.model->draw(frameInfo.commandBuffer);
+        VkPipelineLayout layout = pipelineLayout;
+
+        DrawPacket packet{};
+        packet.sortKey = LveRenderQueue::makeOpaqueKey(RenderLayerOpaque, pipelineId, 0, 0.f);
+        packet.pipeline = lveGPipeline.get();
+        packet.pipelineLayout = pipelineLayout;
+        packet.descriptorSetCount = 3;
+        packet.descriptorSets = waterDescriptorSets;
+        packet.draw = [layout, push, clipmapIndices, clipmapDraws](VkCommandBuffer commandBuffer) {
+            vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                               sizeof(SimplePushConstantData), &push);
+            vkCmdBindIndexBuffer(commandBuffer, clipmapIndices, 0, VK_INDEX_TYPE_UINT16);
+            for (const ClipmapDraw &draw : clipmapDraws) {
+                vkCmdDrawIndexed(commandBuffer, draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, draw.level);
+            }
+        };
+        renderQueue.submit(std::move(packet));
+
+        DrawPacket farFieldPacket{};
+        farFieldPacket.sortKey = LveRenderQueue::makeOpaqueKey(RenderLayerBackground, farFieldPipelineId, 0, 0.f);
+        farFieldPacket.pipeline = farFieldPipeline.get();
+        farFieldPacket.pipelineLayout = pipelineLayout;
+        farFieldPacket.descriptorSetCount = 3;
+        farFieldPacket.descriptorSets = waterDescriptorSets;
+        farFieldPacket.draw = [layout, push](VkCommandBuffer commandBuffer) {
+            vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                               sizeof(SimplePushConstantData), &push);
+            // un seul triangle plein écran
+            vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+        };
+        renderQueue.submit(std::move(farFieldPacket));
     }
 }
 
-}  // namespace lve
\ No newline at end of file
+}  // namespace lve
@@ -2,15 +2,31 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "lve_buffer.hpp"
 #include "lve_device.hpp"
 #include "lve_frame_info.hpp"
 #include "lve_g_pipeline.hpp"
+#include "lve_render_queue.hpp"
+#include "systems/computesSystems/lightCullingSystem.hpp"
 namespace lve {
+/**
+ * Rendu de l'océan sous forme de clipmap procédural centré sur la caméra (voir water.vert) : aucun vertex buffer,
+ * des anneaux de plus en plus espacés avec la distance. Les niveaux partagent un index buffer sur la grille de
+ * (GRID_SIZE + 1)² vertex : le niveau 0 est dessiné en entier, les suivants en quatre blocs autour du trou couvert
+ * par le niveau plus fin, placés par le vertexOffset.
+ */
 class WaterSystem {
    public:
+    // doit correspondre aux constantes de water.vert
+    static constexpr uint32_t CLIPMAP_GRID_SIZE = 128;
+    static constexpr uint32_t CLIPMAP_LEVELS = 5;
+    static constexpr float CLIPMAP_BASE_SPACING = 0.2f;
+
     WaterSystem(LveDevice &device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout,
                 std::vector<std::shared_ptr<LveTexture>> displacementTexture1,
                 std::vector<std::shared_ptr<LveTexture>> derivateTexture1,
@@ -20,18 +36,35 @@ class WaterSystem {
                 std::vector<std::shared_ptr<LveTexture>> turbulenceTexture2,
                 std::vector<std::shared_ptr<LveTexture>> displacementTexture3,
                 std::vector<std::shared_ptr<LveTexture>> derivateTexture3,
-                std::vector<std::shared_ptr<LveTexture>> turbulenceTexture3);
+                std::vector<std::shared_ptr<LveTexture>> turbulenceTexture3,
+                std::shared_ptr<LightCullingSystem> lightCullingSystem);
     ~WaterSystem();
 
     WaterSystem(const LveWindow &) = delete;
     WaterSystem &operator=(const LveWindow &) = delete;
 
-    void renderGameObjects(FrameInfo &frameInfo);
+    // soumet le clipmap avec les opaques et l'océan jusqu'à l'horizon, au-delà du plan far, dans la couche de fond
+    void submit(FrameInfo &frameInfo, LveRenderQueue &renderQueue);
 
     std::shared_ptr<LveDescriptorSetLayout> getWaterTextureSetLayout() { return waterTextureSetLayout; }
     std::vector<VkDescriptorSet> getDescriptorSets() { return descriptorSets; }
 
    private:
+    // une commande indexée du clipmap, firstInstance = niveau
+    struct ClipmapDraw {
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t level;
+    };
+    // 1 bloc pour le niveau 0, 4 pour chaque anneau
+    using ClipmapDraws = std::array<ClipmapDraw, 1 + 4 * (CLIPMAP_LEVELS - 1)>;
+
+    void createClipmapIndexBuffer();
+    void createClipmapBuffers();
+    // place les niveaux autour de la caméra et écrit leur origine dans le buffer de la frame
+    ClipmapDraws updateClipmap(FrameInfo &frameInfo);
+
     void createDescriptorSetLayout();
     void createDescriptorPool();
     void ceateDescriptorSet(std::vector<std::shared_ptr<LveTexture>> displacementTexture1,
@@ -47,9 +80,17 @@ class WaterSystem {
     std::shared_ptr<LveDescriptorSetLayout> waterTextureSetLayout;
     std::unique_ptr<LveDescriptorPool> TexturePool{};
     std::vector<VkDescriptorSet> descriptorSets;
+    std::shared_ptr<LightCullingSystem> lightCullingSystem;
+
+    // grille complète ligne par ligne puis bloc latéral colonne par colonne, voir createClipmapIndexBuffer
+    std::unique_ptr<LveBuffer> clipmapIndexBuffer;
+    uint32_t sideBlockFirstIndex = 0;
+    // origine de chaque niveau, une par frame en vol
+    std::vector<std::unique_ptr<LveBuffer>> clipmapBuffers;
 
     LveDevice &lveDevice;
     std::unique_ptr<LveGPipeline> lveGPipeline;
+    std::unique_ptr<LveGPipeline> farFieldPipeline;
     VkPipelineLayout pipelineLayout;
 };
 }  // namespace lve
\ No newline at end of file
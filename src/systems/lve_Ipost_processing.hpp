@@ -1,13 +1,31 @@
 #pragma once
 
+#include <string>
+
 #include "lve_frame_info.hpp"
 
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
 namespace lve {
 class LveIPostProcessing {
    public:
+    // depthDescriptorSets : LveDescriptorSetLayout::linearDepthSetLayout, profondeur linéaire min/max de la frame
     virtual void executePostCpS(FrameInfo frameInfo, VkDescriptorSet computeDescriptorSets,
                                 VkDescriptorSet depthDescriptorSets, VkExtent2D extent) = 0;
 
+    // appelée à l'ajout de l'effet et quand les images de post-processing changent de taille. Des frames peuvent
+    // encore être en vol : les ressources remplacées doivent être libérées par LveDevice::retire
+    virtual void resize(VkExtent2D extent) {}
+
+    // effet purement par pixel : source GLSL définissant vec4 effect(vec4 color, ivec2 pixel, ivec2 size, vec4 params)
+    // (voir shaders/pixel_effect_layout.glsl), vide sinon. Les effets consécutifs qui en donnent une sont fusionnés
+    // en un seul dispatch par le LvePostProcessingManager, executePostCpS n'est alors pas appelée
+    virtual std::string getPixelFunction() const { return {}; }
+    // params de effect(), relus à chaque frame
+    virtual glm::vec4 getPixelParameters() const { return glm::vec4{0.f}; }
+
    private:
 };
-}  // namespace lve
\ No newline at end of file
+}  // namespace lve
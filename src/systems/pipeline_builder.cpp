@@ -6,6 +6,7 @@
 
 #include "../lve_c_pipeline.hpp"
 #include "../lve_g_pipeline.hpp"
+#include "../lve_model.hpp"
 #include "../lve_utils.hpp"
 
 namespace lve {
@@ -49,11 +50,20 @@ std::unique_ptr<LveGPipeline> PipelineBuilder::BuildGraphicsPipeline(PipelineCre
 
     PipelineConfigInfo pipelineConfig{};
     LveGPipeline::defaultPipeLineConfigInfo(pipelineConfig);
+    if (pipelineCreateInfo.vertexFormat != LveVertexFormatStandard) {
+        pipelineConfig.bindingDescriptions = LveModel::getBindingDescriptions(pipelineCreateInfo.vertexFormat);
+        pipelineConfig.attributeDescriptions = LveModel::getAttributeDescriptions(pipelineCreateInfo.vertexFormat);
+        pipelineConfig.vertexFormat = pipelineCreateInfo.vertexFormat;
+    }
     if (pipelineCreateInfo.functionnality & LvePipelIneFunctionnality::Transparancy) {
         LveGPipeline::enableAlphaBlending(pipelineConfig);
         pipelineConfig.attributeDescriptions.clear();
         pipelineConfig.bindingDescriptions.clear();
     }
+    if (pipelineCreateInfo.functionnality & LvePipelIneFunctionnality::NoVertexInput) {
+        pipelineConfig.attributeDescriptions.clear();
+        pipelineConfig.bindingDescriptions.clear();
+    }
 
     pipelineConfig.renderPass = pipelineCreateInfo.renderPass;
     pipelineConfig.pipelineLayout = pipelineLayout;